@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <benchmark/benchmark.h>
+
+namespace bench {
+// number of calls to the global operator new so far, see main.cpp
+std::size_t allocations() noexcept;
+
+// reports allocations per iteration of the enclosing benchmark loop
+class AllocationCounter {
+  benchmark::State& state;
+  std::size_t start;
+
+public:
+  explicit AllocationCounter(benchmark::State& state) noexcept
+      : state(state)
+      , start(allocations()) {}
+
+  ~AllocationCounter() {
+    state.counters["allocs/op"] =
+        benchmark::Counter(static_cast<double>(allocations() - start), benchmark::Counter::kAvgIterations);
+  }
+};
+}  // namespace bench
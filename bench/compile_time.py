@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""Compile-time cost harness for kwargs.h.
+
+Generates synthetic translation units with N call sites of a given kind,
+compiles each of them with -ftime-trace and summarizes frontend time,
+time spent in included sources, preprocessed size, template instantiation
+counts and peak compiler RSS in a table. Every scenario is compiled once per
+header so the cost of kwargs.h can be compared against kwargs/core.h.
+"""
+
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+SIZES = (10, 100, 1000)
+
+HEADERS = ("kwargs.h", "kwargs/core.h")
+
+# scenarios that need named formatting are skipped for headers without it
+FORMAT_SCENARIOS = {"format"}
+HEADERS_WITHOUT_FORMAT = {"kwargs/core.h"}
+
+PRELUDE = """\
+#define KWARGS_FORMATTING 1
+#include <@HEADER@>
+
+template <typename T>
+int consume(erl::kwargs_t<T> const& kwargs) {
+  return static_cast<int>(std::tuple_size_v<erl::kwargs_t<T>>);
+}
+
+int target(int a0, int a1, int a2, int a3) {
+  return a0 + a1 + a2 + a3;
+}
+"""
+
+
+def kwargs_list(index, count):
+    return ", ".join(f"a{arg}={index}" for arg in range(count))
+
+
+def gen_args(count, arity):
+    body = "\n".join(f"  sum += consume(make_args({kwargs_list(idx, arity)}));" for idx in range(count))
+    return f"int run() {{\n  int sum = 0;\n{body}\n  return sum;\n}}\n"
+
+
+def gen_literals(count, arity):
+    # string and character literals containing separators and brackets exercise the capture list tokenizer
+    values = ('"a, (b"', "','", 'R"x(c)")x"', "1'000")
+    kwargs = ", ".join(f"a{arg}={values[arg % len(values)]}" for arg in range(arity))
+    body = "\n".join(f"  sum += consume(make_args(i={idx}, {kwargs}));" for idx in range(count))
+    return f"int run() {{\n  int sum = 0;\n{body}\n  return sum;\n}}\n"
+
+
+def gen_format(count, arity):
+    fields = " ".join(f"{{a{arg}}}" for arg in range(arity))
+    # every call site gets a distinct format string
+    body = "\n".join(f'  out += erl::format("{idx}: {fields}", make_args({kwargs_list(idx, arity)}));'
+                     for idx in range(count))
+    return f"#include <string>\nstd::string run() {{\n  std::string out;\n{body}\n  return out;\n}}\n"
+
+
+def gen_invoke(count, arity):
+    arity = min(arity, 4)
+    positional = ", ".join(str(idx) for idx in range(4 - arity))
+    keyword = ", ".join(f"a{arg}={arg}" for arg in range(4 - arity, 4))
+    call_args = ", ".join(filter(None, (positional, f"make_args({keyword})")))
+    body = "\n".join(f"  sum += erl::kwargs::invoke<^^target>({call_args});" for _ in range(count))
+    # opt-in on top of kwargs/core.h, already included by kwargs.h
+    return (f"#include <kwargs/invoke.h>\n#if __has_feature(parameter_reflection)\n"
+            f"int run() {{\n  int sum = 0;\n{body}\n  return sum;\n}}\n#endif\n")
+
+
+SCENARIOS = {
+    "args": gen_args,
+    "literals": gen_literals,
+    "format": gen_format,
+    "invoke": gen_invoke,
+}
+
+
+def compile_one(compiler, flags, source, obj):
+    command = [compiler, *flags, "-ftime-trace", "-c", str(source), "-o", str(obj)]
+    log = obj.with_suffix(".log")
+    start = time.perf_counter()
+    with open(log, "w") as stderr:
+        process = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=stderr)
+        # wait4 rather than wait to get the resource usage of this compiler invocation alone
+        _, status, rusage = os.wait4(process.pid, 0)
+    wall = time.perf_counter() - start
+    process.returncode = os.waitstatus_to_exitcode(status)
+    if process.returncode != 0:
+        raise RuntimeError(f"compilation failed: {shlex.join(command)}\n{log.read_text()}")
+    # ru_maxrss is reported in KiB on Linux
+    return wall, rusage.ru_maxrss / 1024
+
+
+def preprocessed_lines(compiler, flags, source):
+    command = [compiler, *flags, "-E", "-P", str(source)]
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, check=True, text=True)
+    return result.stdout.count("\n")
+
+
+def summarize_trace(trace_file):
+    totals = {}
+    with open(trace_file) as file:
+        for event in json.load(file).get("traceEvents", []):
+            name = event.get("name", "")
+            if name.startswith("Total "):
+                totals[name[len("Total "):]] = (event.get("dur", 0) / 1000, event.get("args", {}).get("count", 0))
+    return totals
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--compiler", default=os.environ.get("CXX", "clang++"))
+    parser.add_argument("--include", required=True, help="directory containing kwargs.h")
+    parser.add_argument("--output", required=True, help="directory for generated sources and traces")
+    parser.add_argument("--flags", default="-std=c++26 -freflection -stdlib=libc++ -Wno-c++26-extensions -O0")
+    parser.add_argument("--sizes", default=",".join(map(str, SIZES)))
+    parser.add_argument("--arity", default="1,4")
+    parser.add_argument("--scenarios", default=",".join(SCENARIOS))
+    parser.add_argument("--headers", default=",".join(HEADERS))
+    args = parser.parse_args()
+
+    output = Path(args.output)
+    output.mkdir(parents=True, exist_ok=True)
+    flags = [*shlex.split(args.flags), f"-I{args.include}"]
+
+    rows = []
+    for header in args.headers.split(","):
+        prelude = PRELUDE.replace("@HEADER@", header)
+        for scenario in args.scenarios.split(","):
+            if scenario in FORMAT_SCENARIOS and header in HEADERS_WITHOUT_FORMAT:
+                continue
+            for arity in map(int, args.arity.split(",")):
+                for size in map(int, args.sizes.split(",")):
+                    tag = Path(header).stem
+                    stem = output / f"{tag}_{scenario}_{arity}_{size}"
+                    source = stem.with_suffix(".cpp")
+                    source.write_text(prelude + SCENARIOS[scenario](size, arity))
+
+                    wall, rss = compile_one(args.compiler, flags, source, stem.with_suffix(".o"))
+                    totals = summarize_trace(stem.with_suffix(".json"))
+                    frontend = totals.get("Frontend", (0, 0))[0]
+                    included = totals.get("Source", (0, 0))[0]
+                    functions = totals.get("InstantiateFunction", (0, 0))[1]
+                    classes = totals.get("InstantiateClass", (0, 0))[1]
+                    lines = preprocessed_lines(args.compiler, flags, source)
+                    rows.append((header, scenario, arity, size, wall * 1000, frontend, included, lines, functions,
+                                 classes, rss))
+                    print(f"{source.name}: {wall * 1000:.0f} ms", file=sys.stderr)
+
+    columns = ("header", "scenario", "args", "call sites", "wall [ms]", "frontend [ms]", "sources [ms]",
+               "preprocessed lines", "fn instantiations", "class instantiations", "peak RSS [MiB]")
+    lines = ["| " + " | ".join(columns) + " |", "|" + "---|" * len(columns)]
+    for header, scenario, arity, size, wall, frontend, included, count, functions, classes, rss in rows:
+        lines.append(f"| {header} | {scenario} | {arity} | {size} | {wall:.0f} | {frontend:.0f} | {included:.0f} | "
+                     f"{count} | {functions} | {classes} | {rss:.1f} |")
+    summary = "\n".join(lines) + "\n"
+    (output / "summary.md").write_text(summary)
+    print(summary)
+
+
+if __name__ == "__main__":
+    main()
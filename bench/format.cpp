@@ -0,0 +1,183 @@
+#include <cstdio>
+#include <format>
+#include <print>
+#include <string>
+#include <benchmark/benchmark.h>
+
+#include <kwargs.h>
+
+#include "alloc.h"
+
+namespace {
+std::FILE* null_stream() {
+  static std::FILE* stream = std::fopen("/dev/null", "w");
+  return stream;
+}
+
+// 1 field
+
+void BM_Format1_Std(benchmark::State& state) {
+  int a = 1;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(std::format("a={}", a));
+  }
+}
+BENCHMARK(BM_Format1_Std);
+
+void BM_Format1_Named(benchmark::State& state) {
+  int a = 1;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(erl::format("a={a}", make_args(a)));
+  }
+}
+BENCHMARK(BM_Format1_Named);
+
+void BM_Println1_Std(benchmark::State& state) {
+  int a = 1;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    std::println(null_stream(), "a={}", a);
+  }
+}
+BENCHMARK(BM_Println1_Std);
+
+void BM_Println1_Named(benchmark::State& state) {
+  int a = 1;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    erl::println(null_stream(), "a={a}", make_args(a));
+  }
+}
+BENCHMARK(BM_Println1_Named);
+
+// 4 fields
+
+void BM_Format4_Std(benchmark::State& state) {
+  int a = 1;
+  double b = 2.5;
+  std::string c = "three";
+  bool d = true;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(std::format("a={} b={} c={} d={}", a, b, c, d));
+  }
+}
+BENCHMARK(BM_Format4_Std);
+
+void BM_Format4_Named(benchmark::State& state) {
+  int a = 1;
+  double b = 2.5;
+  std::string c = "three";
+  bool d = true;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(erl::format("a={a} b={b} c={c} d={d}", make_args_ref(a, b, c, d)));
+  }
+}
+BENCHMARK(BM_Format4_Named);
+
+void BM_Println4_Std(benchmark::State& state) {
+  int a = 1;
+  double b = 2.5;
+  std::string c = "three";
+  bool d = true;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    std::println(null_stream(), "a={} b={} c={} d={}", a, b, c, d);
+  }
+}
+BENCHMARK(BM_Println4_Std);
+
+void BM_Println4_Named(benchmark::State& state) {
+  int a = 1;
+  double b = 2.5;
+  std::string c = "three";
+  bool d = true;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    erl::println(null_stream(), "a={a} b={b} c={c} d={d}", make_args_ref(a, b, c, d));
+  }
+}
+BENCHMARK(BM_Println4_Named);
+
+// 16 fields
+
+#define BENCH_FIELDS_16                                                                                  \
+  int f0 = 0, f1 = 1, f2 = 2, f3 = 3, f4 = 4, f5 = 5, f6 = 6, f7 = 7, f8 = 8, f9 = 9, f10 = 10, f11 = 11, \
+      f12 = 12, f13 = 13, f14 = 14, f15 = 15
+
+void BM_Format16_Std(benchmark::State& state) {
+  BENCH_FIELDS_16;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f0);
+    benchmark::DoNotOptimize(std::format("{} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {}", f0, f1, f2, f3, f4, f5,
+                                         f6, f7, f8, f9, f10, f11, f12, f13, f14, f15));
+  }
+}
+BENCHMARK(BM_Format16_Std);
+
+void BM_Format16_Named(benchmark::State& state) {
+  BENCH_FIELDS_16;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f0);
+    benchmark::DoNotOptimize(
+        erl::format("{f0} {f1} {f2} {f3} {f4} {f5} {f6} {f7} {f8} {f9} {f10} {f11} {f12} {f13} {f14} {f15}",
+                    make_args_ref(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15)));
+  }
+}
+BENCHMARK(BM_Format16_Named);
+
+void BM_Println16_Std(benchmark::State& state) {
+  BENCH_FIELDS_16;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f0);
+    std::println(null_stream(), "{} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {}", f0, f1, f2, f3, f4, f5, f6, f7, f8,
+                 f9, f10, f11, f12, f13, f14, f15);
+  }
+}
+BENCHMARK(BM_Println16_Std);
+
+void BM_Println16_Named(benchmark::State& state) {
+  BENCH_FIELDS_16;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f0);
+    erl::println(null_stream(),
+                 "{f0} {f1} {f2} {f3} {f4} {f5} {f6} {f7} {f8} {f9} {f10} {f11} {f12} {f13} {f14} {f15}",
+                 make_args_ref(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15));
+  }
+}
+BENCHMARK(BM_Println16_Named);
+
+// constant arguments
+
+void BM_ConstantFormat_Named(benchmark::State& state) {
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(erl::format("{svc}.{metric}.count", make_args(svc = "api", metric = "req")));
+  }
+}
+BENCHMARK(BM_ConstantFormat_Named);
+
+void BM_ConstantFormat_Static(benchmark::State& state) {
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    static auto const name = erl::static_format<"{svc}.{metric}.count">(make_args(svc = "api", metric = "req"));
+    benchmark::DoNotOptimize(name.view());
+  }
+}
+BENCHMARK(BM_ConstantFormat_Static);
+}  // namespace
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include <kwargs.h>
+
+#include "alloc.h"
+
+namespace {
+auto record(int id, std::string_view name, double value) {
+  return make_args(id, name, value);
+}
+using record_t = decltype(record(0, {}, 0));
+
+std::vector<record_t> const& records() {
+  static auto const result = [] {
+    std::vector<record_t> values;
+    for (int idx = 0; idx < 1'000'000; ++idx) {
+      values.push_back(record(idx, idx % 2 == 0 ? "even" : "odd", idx * 0.25));
+    }
+    return values;
+  }();
+  return result;
+}
+
+void BM_FormatRange_Loop(benchmark::State& state) {
+  auto const& input = records();
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    std::string out;
+    for (auto const& entry : input) {
+      out += erl::format("{id};{name};{value}", entry);
+      out += '\n';
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_FormatRange_Loop)->Unit(benchmark::kMillisecond);
+
+// the argument is the number of threads, doubling up to the core count
+void BM_FormatRange(benchmark::State& state) {
+  auto const& input = records();
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    std::string out;
+    erl::format_range("{id};{name};{value}", input, out, {.threads = static_cast<unsigned>(state.range(0))});
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_FormatRange)
+    ->Apply([](benchmark::internal::Benchmark* bench) {
+      auto const cores = std::max(1U, std::thread::hardware_concurrency());
+      for (unsigned threads = 1; threads < cores; threads *= 2) {
+        bench->Arg(threads);
+      }
+      bench->Arg(cores);
+    })
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Small ranges split across all cores regardless of their size, against one
+// thread. The size where splitting starts to pay off is the lower bound for
+// the default `min_records_per_thread` times the core count.
+void BM_FormatRange_Split(benchmark::State& state) {
+  auto const input   = std::span{records()}.first(static_cast<std::size_t>(state.range(0)));
+  auto const threads = static_cast<unsigned>(state.range(1));
+  for (auto _ : state) {
+    std::string out;
+    erl::format_range("{id};{name};{value}", input, out, {.threads = threads, .min_records_per_thread = 1});
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_FormatRange_Split)
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 18, 4), {1, 0}})
+    ->ArgNames({"records", "threads"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+#include <kwargs.h>
+
+#include "alloc.h"
+
+#if __has_feature(parameter_reflection)
+namespace {
+[[gnu::noinline]] int target(int x, int y, int z) {
+  return x * y + z;
+}
+
+void BM_DirectCall(benchmark::State& state) {
+  int x = 3;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(target(x, 4, 5));
+  }
+}
+BENCHMARK(BM_DirectCall);
+
+void BM_Invoke(benchmark::State& state) {
+  int x = 3;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(erl::kwargs::invoke<^^target>(x, make_args(z = 5, y = 4)));
+  }
+}
+BENCHMARK(BM_Invoke);
+
+void BM_Bind(benchmark::State& state) {
+  int x      = 3;
+  auto bound = erl::kwargs::bind<^^target>(make_args(z = 5, y = 4));
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(bound(x));
+  }
+}
+BENCHMARK(BM_Bind);
+
+void BM_Lambda(benchmark::State& state) {
+  int x      = 3;
+  auto bound = [y = 4, z = 5](int x) { return target(x, y, z); };
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(bound(x));
+  }
+}
+BENCHMARK(BM_Lambda);
+}  // namespace
+#endif
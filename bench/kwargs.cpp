@@ -0,0 +1,78 @@
+#include <string_view>
+#include <benchmark/benchmark.h>
+#include <kwargs.h>
+
+#include "alloc.h"
+
+namespace {
+struct Options {
+  int x;
+  double y;
+  std::string_view name;
+};
+
+[[gnu::noinline]] double with_struct(Options const& options) {
+  return options.x * options.y + static_cast<double>(options.name.size());
+}
+
+[[gnu::noinline]] double with_positional(int x, double y, std::string_view name) {
+  return x * y + static_cast<double>(name.size());
+}
+
+template <typename T>
+[[gnu::noinline]] double with_kwargs(erl::kwargs_t<T> const& kwargs) {
+  return get<"x">(kwargs) * get<"y">(kwargs) + static_cast<double>(get_or<"name">(kwargs, std::string_view{}).size());
+}
+
+void BM_PlainStruct(benchmark::State& state) {
+  int x = 3;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(with_struct(Options{.x = x, .y = 1.5, .name = "foo"}));
+  }
+}
+BENCHMARK(BM_PlainStruct);
+
+void BM_Positional(benchmark::State& state) {
+  int x = 3;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(with_positional(x, 1.5, "foo"));
+  }
+}
+BENCHMARK(BM_Positional);
+
+void BM_MakeArgs(benchmark::State& state) {
+  int x = 3;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(with_kwargs(make_args(x, y = 1.5, name = std::string_view{"foo"})));
+  }
+}
+BENCHMARK(BM_MakeArgs);
+
+void BM_MakeArgsDefault(benchmark::State& state) {
+  int x = 3;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(with_kwargs(make_args(x, y = 1.5)));
+  }
+}
+BENCHMARK(BM_MakeArgsDefault);
+
+void BM_MakeArgsRef(benchmark::State& state) {
+  int x                 = 3;
+  double y              = 1.5;
+  std::string_view name = "foo";
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(with_kwargs(make_args_ref(x, y, name)));
+  }
+}
+BENCHMARK(BM_MakeArgsRef);
+}  // namespace
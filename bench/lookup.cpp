@@ -0,0 +1,90 @@
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <benchmark/benchmark.h>
+#include <kwargs.h>
+
+#include "alloc.h"
+#include "../tests/kwargs/fields.h"
+
+namespace {
+using test::make_fields;
+
+// names queried in every iteration, a mix of hits spread over the pack and misses
+template <std::size_t N>
+std::array<std::string, 8> queries() {
+  std::array<std::string, 8> result;
+  for (std::size_t idx = 0; idx < 6; ++idx) {
+    result[idx] = "field_" + std::to_string(idx * N / 6);
+  }
+  result[6] = "field_x";
+  result[7] = "other";
+  return result;
+}
+
+// the if-else chain runtime lookups are written as without visit_arg
+template <typename T, typename F>
+bool linear_visit(T& kwargs, std::string_view name, F&& visitor) {
+  using kwarg_tuple = typename T::type;
+  return [:erl::_kwargs_impl::sequence(erl::_kwargs_impl::member_count<kwarg_tuple>):] >> [&]<auto... Idx> {
+    return ((name == erl::_kwargs_impl::member_names<kwarg_tuple>[Idx].name() && (visitor(get<Idx>(kwargs)), true)) ||
+            ...);
+  };
+}
+
+template <std::size_t N>
+void BM_LinearLookup(benchmark::State& state) {
+  auto fields = make_fields<N>();
+  auto names  = queries<N>();
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    for (auto const& name : names) {
+      benchmark::DoNotOptimize(name);
+      int sum = 0;
+      linear_visit(fields, name, [&](int value) { sum += value; });
+      benchmark::DoNotOptimize(sum);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_LinearLookup<4>);
+BENCHMARK(BM_LinearLookup<16>);
+BENCHMARK(BM_LinearLookup<64>);
+
+template <std::size_t N>
+void BM_VisitArg(benchmark::State& state) {
+  auto fields = make_fields<N>();
+  auto names  = queries<N>();
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    for (auto const& name : names) {
+      benchmark::DoNotOptimize(name);
+      int sum = 0;
+      erl::visit_arg(fields, name, [&](int value) { sum += value; });
+      benchmark::DoNotOptimize(sum);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_VisitArg<4>);
+BENCHMARK(BM_VisitArg<16>);
+BENCHMARK(BM_VisitArg<64>);
+
+template <std::size_t N>
+void BM_FindArg(benchmark::State& state) {
+  auto fields = make_fields<N>();
+  auto names  = queries<N>();
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    for (auto const& name : names) {
+      benchmark::DoNotOptimize(name);
+      benchmark::DoNotOptimize(erl::find_arg<int>(fields, name));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_FindArg<4>);
+BENCHMARK(BM_FindArg<16>);
+BENCHMARK(BM_FindArg<64>);
+}  // namespace
@@ -0,0 +1,47 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <benchmark/benchmark.h>
+
+#include "alloc.h"
+
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+
+void* allocate(std::size_t size, std::size_t alignment) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (size == 0) {
+    size = 1;
+  }
+  void* ptr = alignment <= alignof(std::max_align_t) ? std::malloc(size)
+                                                     : std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+  if (ptr == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return ptr;
+}
+}  // namespace
+
+std::size_t bench::allocations() noexcept {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+// the remaining forms of operator new and delete forward to these by default
+void* operator new(std::size_t size) {
+  return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,51 @@
+#include <cstdio>
+#include <benchmark/benchmark.h>
+
+#define KWARGS_SINKS 1
+#include <kwargs.h>
+
+#include "alloc.h"
+
+namespace {
+std::FILE* null_stream() {
+  static std::FILE* stream = std::fopen("/dev/null", "w");
+  return stream;
+}
+
+// every thread prints lines of the same shape, contention is on the destination
+
+void BM_Println_File(benchmark::State& state) {
+  int thread = state.thread_index();
+  int line   = 0;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    erl::println(null_stream(), "thread={thread} line={line}", make_args(thread, line));
+    ++line;
+  }
+}
+BENCHMARK(BM_Println_File)->Threads(1)->Threads(4)->Threads(8);
+
+void BM_Println_FileSink(benchmark::State& state) {
+  static erl::FileSink sink{null_stream()};
+  int thread = state.thread_index();
+  int line   = 0;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    erl::println(sink, "thread={thread} line={line}", make_args(thread, line));
+    ++line;
+  }
+}
+BENCHMARK(BM_Println_FileSink)->Threads(1)->Threads(4)->Threads(8);
+
+void BM_Println_FdSink(benchmark::State& state) {
+  static erl::FdSink sink{fileno(null_stream())};
+  int thread = state.thread_index();
+  int line   = 0;
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    erl::println(sink, "thread={thread} line={line}", make_args(thread, line));
+    ++line;
+  }
+}
+BENCHMARK(BM_Println_FdSink)->Threads(1)->Threads(4)->Threads(8);
+}  // namespace
@@ -0,0 +1,72 @@
+#include <format>
+#include <string>
+#include <string_view>
+#include <benchmark/benchmark.h>
+
+#include <kwargs.h>
+
+#include "alloc.h"
+
+namespace {
+// the std::format baseline neither escapes nor quotes conditionally, it is a lower bound for hand-written builders
+
+void BM_Json_Std(benchmark::State& state) {
+  int id = 42;
+  double ms = 1.25;
+  std::string_view path = "/api/v1/items";
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(id);
+    benchmark::DoNotOptimize(std::format(R"({{"id":{},"ms":{},"path":"{}","ok":{}}})", id, ms, path, true));
+  }
+}
+BENCHMARK(BM_Json_Std);
+
+void BM_Json_Kwargs(benchmark::State& state) {
+  int id = 42;
+  double ms = 1.25;
+  std::string_view path = "/api/v1/items";
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(id);
+    benchmark::DoNotOptimize(erl::to_json(make_args(id, ms, path, ok = true)));
+  }
+}
+BENCHMARK(BM_Json_Kwargs);
+
+void BM_Logfmt_Std(benchmark::State& state) {
+  int id = 42;
+  double ms = 1.25;
+  std::string_view path = "/api/v1/items";
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(id);
+    benchmark::DoNotOptimize(std::format("id={} ms={} path={} ok={}", id, ms, path, true));
+  }
+}
+BENCHMARK(BM_Logfmt_Std);
+
+void BM_Logfmt_Kwargs(benchmark::State& state) {
+  int id = 42;
+  double ms = 1.25;
+  std::string_view path = "/api/v1/items";
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(id);
+    benchmark::DoNotOptimize(erl::to_logfmt(make_args(id, ms, path, ok = true)));
+  }
+}
+BENCHMARK(BM_Logfmt_Kwargs);
+
+// escaping cost on a long string, range(0) is the length
+void BM_JsonEscape(benchmark::State& state) {
+  std::string text(static_cast<std::size_t>(state.range(0)), 'x');
+  text.back() = '"';
+  bench::AllocationCounter allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(erl::to_json(make_args_ref(text)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JsonEscape)->Arg(16)->Arg(256)->Arg(4096);
+}  // namespace
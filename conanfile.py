@@ -19,12 +19,13 @@ class KwargsRecipe(ConanFile):
     options = {
         "coverage": [True, False],
         "formatting": [True, False],
-        "examples": [True, False]
+        "examples": [True, False],
+        "benchmarks": [True, False]
     }
-    default_options = {"coverage": False, "formatting": True, "examples": True}
+    default_options = {"coverage": False, "formatting": True, "examples": True, "benchmarks": False}
     generators = "CMakeToolchain", "CMakeDeps"
 
-    exports_sources = "CMakeLists.txt", "include/*"
+    exports_sources = "CMakeLists.txt", "include/*", "module/*"
 
     def requirements(self):
         # if self.options.fmt:
@@ -33,6 +34,8 @@ class KwargsRecipe(ConanFile):
         #                   transitive_libs=True)
 
         self.test_requires("gtest/1.14.0")
+        if self.options.benchmarks:
+            self.test_requires("benchmark/1.8.3")
 
     def layout(self):
         cmake_layout(self)
@@ -43,8 +46,9 @@ class KwargsRecipe(ConanFile):
             cmake.configure(
                 variables={
                     "ENABLE_COVERAGE": self.options.coverage,
-                    "KWARGS_FORMATTING": self.options.formatting,
+                    "ENABLE_FORMAT": self.options.formatting,
                     "ENABLE_EXAMPLES": self.options.examples,
+                    "BUILD_BENCHMARKS": self.options.benchmarks,
                     # "ENABLE_FMTLIB": self.options.fmt,
                 }
             )
@@ -52,6 +56,7 @@ class KwargsRecipe(ConanFile):
 
     def package(self):
         copy(self, "*.h", self.source_folder, self.package_folder)
+        copy(self, "*.cppm", self.source_folder, self.package_folder)
 
     def package_info(self):
         self.cpp_info.bindirs = []
@@ -0,0 +1,10 @@
+import erl.kwargs.format;
+
+// macros are not exported from modules
+#include <kwargs/macros.h>
+
+int main() {
+  int x = 3;
+  erl::println("{x} {y}", make_args(x, y = 42));
+  return get<"y">(make_args(y = 0));
+}
@@ -0,0 +1,68 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Named formatting: erl::format, print and friends. kwargs.h includes
+// kwargs/format.h when enabled, kwargs/core.h never depends on it.
+#ifndef KWARGS_FORMATTING
+#  define KWARGS_FORMATTING 1
+#endif
+
+// When enabled, make_args yields interned packs: call sites passing the same
+// names and types share one type, members are ordered by name.
+#ifndef KWARGS_CANONICAL
+#  define KWARGS_CANONICAL 0
+#endif
+
+// Deferred-formatting logger, requires KWARGS_FORMATTING.
+#ifndef KWARGS_LOGGING
+#  define KWARGS_LOGGING 0
+#endif
+
+// Buffered, batched output sinks for print/println, requires KWARGS_FORMATTING.
+#ifndef KWARGS_SINKS
+#  define KWARGS_SINKS 0
+#endif
+
+// Per call site counters for named formatting and kwargs::invoke, see erl::stats.
+// Must be set consistently for all translation units of a program.
+#ifndef KWARGS_STATS
+#  define KWARGS_STATS 0
+#endif
+
+// Additionally measure the duration of every counted call in cycles.
+#ifndef KWARGS_STATS_CYCLES
+#  define KWARGS_STATS_CYCLES 0
+#endif
+
+// Number of call sites with per-thread counters, further sites share one
+// atomic counter set between all threads.
+#ifndef KWARGS_STATS_CAPACITY
+#  define KWARGS_STATS_CAPACITY 1024
+#endif
+
+// Expands to `export` when included by the module interfaces in module/.
+#ifndef KWARGS_EXPORT
+#  define KWARGS_EXPORT
+#endif
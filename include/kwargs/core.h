@@ -0,0 +1,739 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <meta>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.h"
+
+KWARGS_EXPORT namespace erl {
+
+template <typename Impl>
+struct [[nodiscard]] kwargs_t : Impl {
+  using type = Impl;
+};
+
+template <typename T>
+concept is_kwargs = has_template_arguments(^^T) && template_of(^^T) == ^^kwargs_t;
+
+namespace _kwargs_impl {
+
+template <std::size_t N>
+struct fixed_string {
+  constexpr static auto size = N;
+
+  constexpr fixed_string() = default;
+  constexpr explicit(false) fixed_string(const char (&str)[N + 1]) noexcept {
+    auto idx = std::size_t{0};
+    for (char const chr : str) {
+      data[idx++] = chr;
+    }
+  }
+  constexpr explicit fixed_string(std::same_as<char> auto... Vs) : data{Vs...} {}
+  constexpr explicit fixed_string(std::string_view str) { str.copy(data, N); }
+  constexpr explicit(false) operator std::string_view() const { return std::string_view{data}; }
+
+  char data[N + 1]{};
+};
+
+template <std::size_t N>
+fixed_string(char const (&)[N]) -> fixed_string<N - 1>;
+
+// Fixed-capacity replacement for std::vector in constant evaluation. Parsers
+// know an upper bound for their output, so they never allocate while parsing.
+template <typename T, std::size_t Capacity>
+struct fixed_vector {
+  std::array<T, Capacity> items{};
+  std::size_t count = 0;
+
+  // returns false if the capacity is exhausted
+  [[nodiscard]] constexpr bool push_back(T value) {
+    if (count == Capacity) {
+      return false;
+    }
+    items[count++] = std::move(value);
+    return true;
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const { return count; }
+  [[nodiscard]] constexpr bool empty() const { return count == 0; }
+  [[nodiscard]] constexpr auto begin() const { return items.begin(); }
+  [[nodiscard]] constexpr auto end() const { return items.begin() + count; }
+  [[nodiscard]] constexpr T const& operator[](std::size_t idx) const { return items[idx]; }
+  [[nodiscard]] constexpr std::string_view view() const
+    requires std::same_as<T, char>
+  {
+    return {items.data(), count};
+  }
+};
+
+// writes the decimal representation of `value` to `out`, returns the end
+constexpr char* write_decimal(char* out, std::size_t value) {
+  char digits[20];
+  char* cursor = digits;
+  do {
+    *cursor++ = static_cast<char>('0' + (value % 10U));
+    value /= 10;
+  } while (value > 0);
+  while (cursor != digits) {
+    *out++ = *--cursor;
+  }
+  return out;
+}
+
+constexpr std::string utos(unsigned value) {
+  char digits[20];
+  return {digits, write_decimal(digits, value)};
+}
+
+constexpr bool is_whitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr bool is_identifier_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+struct Parser {
+  std::string_view data;
+  std::size_t cursor{0};
+
+  constexpr void skip_whitespace() {
+    while (is_valid()) {
+      if (char c = current(); is_whitespace(c) || c == '\\') {
+        ++cursor;
+      } else {
+        break;
+      }
+    }
+  }
+
+  constexpr void skip_to(std::same_as<char> auto... needles) {
+    int brace_count = 0;
+    while (is_valid()) {
+      if (char c = current(); brace_count == 0 && ((c == needles) || ...)) {
+        break;
+      } else if (c == '[' || c == '{' || c == '(') {
+        ++brace_count;
+      } else if (c == ']' || c == '}' || c == ')') {
+        --brace_count;
+      }
+      ++cursor;
+    }
+  }
+
+  // Like skip_to, but treats the input as C++ expressions: string and
+  // character literals (including raw strings) are skipped as a whole, so
+  // delimiters and brackets inside them are not counted.
+  constexpr void skip_expression_to(std::same_as<char> auto... needles) {
+    int brace_count = 0;
+    while (is_valid()) {
+      if (char c = current(); brace_count == 0 && ((c == needles) || ...)) {
+        break;
+      } else if (c == '[' || c == '{' || c == '(') {
+        ++brace_count;
+      } else if (c == ']' || c == '}' || c == ')') {
+        --brace_count;
+      } else if (c == '"' || (c == '\'' && !is_digit_separator())) {
+        skip_literal();
+        continue;
+      }
+      ++cursor;
+    }
+  }
+
+  [[nodiscard]] constexpr char current() const { return data[cursor]; }
+  [[nodiscard]] constexpr bool is_valid() const { return cursor < data.length(); }
+
+private:
+  // the token preceding the cursor, ie. a literal prefix or the digits of a number
+  [[nodiscard]] constexpr std::string_view preceding_token() const {
+    auto start = cursor;
+    while (start > 0 && (is_identifier_char(data[start - 1]) || data[start - 1] == '\'' || data[start - 1] == '.')) {
+      --start;
+    }
+    return data.substr(start, cursor - start);
+  }
+
+  // a quote inside a number such as 1'000 separates digits
+  [[nodiscard]] constexpr bool is_digit_separator() const {
+    auto token = preceding_token();
+    return !token.empty() && token[0] >= '0' && token[0] <= '9';
+  }
+
+  [[nodiscard]] constexpr bool is_raw_string() const {
+    auto token = preceding_token();
+    return token == "R" || token == "u8R" || token == "uR" || token == "UR" || token == "LR";
+  }
+
+  // skips the string or character literal starting at the cursor
+  constexpr void skip_literal() {
+    char const quote = current();
+    if (quote == '"' && is_raw_string()) {
+      auto open = data.find('(', cursor);
+      if (open == std::string_view::npos) {
+        cursor = data.size();
+        return;
+      }
+      // R"delim( ... )delim"
+      auto delimiter = data.substr(cursor + 1, open - cursor - 1);
+      for (auto end = data.find(')', open); end != std::string_view::npos; end = data.find(')', end + 1)) {
+        if (data.substr(end + 1).starts_with(delimiter) && data.substr(end + 1 + delimiter.size()).starts_with('"')) {
+          cursor = end + delimiter.size() + 2;
+          return;
+        }
+      }
+      cursor = data.size();
+      return;
+    }
+
+    ++cursor;
+    while (is_valid() && current() != quote) {
+      if (current() == '\\') {
+        ++cursor;
+      }
+      ++cursor;
+    }
+    ++cursor;
+  }
+};
+
+// Packs declare their members in decreasing order of alignment to minimize
+// padding. If that differs from the argument order, this empty tag is
+// appended as last member, Positions lists the declaration index of every
+// argument. Everything outside of construction works in argument order.
+template <std::size_t... Positions>
+struct member_order {};
+
+constexpr inline std::string_view member_order_name = "_kwargs_member_order";
+
+consteval bool is_member_order(std::meta::info member) {
+  auto type = type_of(member);
+  return has_template_arguments(type) && template_of(type) == ^^member_order;
+}
+
+// members in argument order, without the order tag
+consteval std::vector<std::meta::info> logical_members(std::meta::info reflection) {
+  auto declared = nonstatic_data_members_of(reflection, std::meta::access_context::unchecked());
+  if (declared.empty() || !is_member_order(declared.back())) {
+    return declared;
+  }
+
+  std::vector<std::meta::info> result;
+  for (auto position : template_arguments_of(type_of(declared.back()))) {
+    result.push_back(declared[extract<std::size_t>(position)]);
+  }
+  return result;
+}
+
+consteval std::meta::info get_nth_member(std::meta::info reflection, std::size_t n) {
+  return logical_members(reflection)[n];
+}
+
+consteval std::size_t storage_alignment(std::meta::info type) {
+  return is_reference_type(type) ? alignof(void*) : alignment_of(type);
+}
+
+// Member descriptions for a pack holding arguments of the given types and names.
+consteval std::vector<std::meta::info> pack_members(std::vector<std::meta::info> const& types,
+                                                    std::ranges::input_range auto const& names) {
+  std::vector<std::size_t> declared;
+  for (std::size_t idx = 0; idx < types.size(); ++idx) {
+    declared.push_back(idx);
+  }
+  std::ranges::stable_sort(declared, std::ranges::greater{}, [&](std::size_t idx) { return storage_alignment(types[idx]); });
+
+  std::vector<std::string_view> arg_names(std::ranges::begin(names), std::ranges::end(names));
+  std::vector<std::meta::info> specs;
+  for (auto idx : declared) {
+    specs.push_back(data_member_spec(types[idx], {.name = arg_names[idx]}));
+  }
+
+  if (!std::ranges::is_sorted(declared)) {
+    std::vector<std::meta::info> positions(types.size());
+    for (std::size_t position = 0; position < declared.size(); ++position) {
+      positions[declared[position]] = std::meta::reflect_constant(position);
+    }
+    specs.push_back(data_member_spec(substitute(^^member_order, positions),
+                                     {.name = member_order_name, .no_unique_address = true}));
+  }
+  return specs;
+}
+
+// the argument index of every declared member, in declaration order
+template <typename T>
+consteval std::vector<std::size_t> declaration_order() {
+  auto logical = logical_members(^^T);
+  std::vector<std::size_t> order;
+  for (auto member : nonstatic_data_members_of(^^T, std::meta::access_context::unchecked())) {
+    if (auto it = std::ranges::find(logical, member); it != logical.end()) {
+      order.push_back(static_cast<std::size_t>(it - logical.begin()));
+    }
+  }
+  return order;
+}
+
+// reorders per-argument values to match the declaration order of T, ie. for aggregate initialization
+template <typename T, typename V>
+consteval std::vector<V> in_declaration_order(std::vector<V> const& values) {
+  std::vector<V> result;
+  for (auto idx : declaration_order<T>()) {
+    result.push_back(values[idx]);
+  }
+  return result;
+}
+
+struct member_name {
+  char const* data;
+  std::size_t size;
+  std::size_t index;
+
+  [[nodiscard]] constexpr std::string_view name() const { return {data, size}; }
+};
+
+template <typename T>
+consteval std::vector<member_name> make_member_names(bool sorted) {
+  std::vector<member_name> names;
+  for (auto member : logical_members(^^T)) {
+    auto name = identifier_of(member);
+    names.push_back({std::define_static_string(name), name.size(), names.size()});
+  }
+  if (sorted) {
+    std::ranges::sort(names, {}, &member_name::name);
+  }
+  return names;
+}
+
+// The member tables are computed once per type. All name and index lookups
+// go through them rather than querying the members of T again.
+template <typename T>
+constexpr inline std::span<std::meta::info const> members = define_static_array(logical_members(^^T));
+
+// in argument order
+template <typename T>
+constexpr inline std::span<member_name const> member_names = define_static_array(make_member_names<T>(false));
+
+// sorted by name
+template <typename T>
+constexpr inline std::span<member_name const> member_lookup = define_static_array(make_member_names<T>(true));
+
+template <typename T>
+consteval std::size_t get_member_index(std::string_view name) {
+  auto const& table = member_lookup<T>;
+  if (auto it = std::ranges::lower_bound(table, name, {}, &member_name::name);
+      it != table.end() && it->name() == name) {
+    return it->index;
+  }
+  return -1UZ;
+}
+
+template <typename T>
+consteval bool has_member(std::string_view name) {
+  return get_member_index<T>(name) != -1UZ;
+}
+
+template <typename T>
+consteval auto get_member_names() {
+  return member_names<T> | std::views::transform(&member_name::name);
+}
+
+template <typename T>
+consteval bool has_only_reference_members() {
+  return std::ranges::all_of(members<T>, [](std::meta::info member) { return is_reference_type(type_of(member)); });
+}
+
+template <typename T>
+constexpr inline std::size_t member_count = members<T>.size();
+
+namespace impl {
+template <auto... Vs>
+struct Replicator {
+  template <typename F>
+  constexpr decltype(auto) operator>>(F fnc) const {
+    return fnc.template operator()<Vs...>();
+  }
+
+  template <typename F>
+  constexpr void operator>>=(F fnc) const {
+    (fnc.template operator()<Vs>(), ...);
+  }
+};
+
+template <auto... Vs>
+constexpr inline Replicator<Vs...> replicator{};
+}  // namespace impl
+
+template <std::ranges::range R>
+consteval auto expand(R const& range) {
+  std::vector<std::meta::info> args;
+  for (auto item : range) {
+    args.push_back(std::meta::reflect_constant(item));
+  }
+  return substitute(^^impl::replicator, args);
+}
+
+consteval auto sequence(unsigned maximum) {
+  return expand(std::ranges::iota_view{0U, maximum});
+}
+
+}  // namespace _kwargs_impl
+
+namespace kwargs {
+// Parses the capture list of make_args into the capture names. Capacity bounds
+// the number of captures, parsing fails if there are more.
+template <std::size_t Capacity>
+struct BasicNameParser : _kwargs_impl::Parser {
+  _kwargs_impl::fixed_vector<std::string_view, Capacity> names;
+
+  constexpr bool parse() {
+    cursor = 0;
+
+    while (is_valid()) {
+      skip_whitespace();
+
+      if (current() == '&') {
+        // might be captured by reference
+        ++cursor;
+        skip_whitespace();
+      }
+
+      if (current() == '.') {
+        // pack captured, reject
+        return false;
+      }
+
+      std::size_t start = cursor;
+
+      // find '=', ',' or whitespace
+      skip_expression_to('=', ',', ' ', '\n', '\r', '\t');
+      if (cursor - start == 0) {
+        // default capture or invalid name
+        return false;
+      }
+
+      auto name = data.substr(start, cursor - start);
+      if (name == "this" || name == "*this") {
+        // this captured, reject
+        return false;
+      }
+      if (!names.push_back(name)) {
+        return false;
+      }
+
+      // skip ahead to next capture
+      // if the current character is already ',', this will not move the cursor
+      skip_expression_to(',');
+      ++cursor;
+
+      skip_whitespace();
+    }
+    return true;
+  }
+};
+
+using NameParser = BasicNameParser<64>;
+
+// every capture takes at least two characters of the capture list, including the separator
+template <_kwargs_impl::fixed_string Names>
+using name_parser_for = BasicNameParser<decltype(Names)::size / 2 + 1>;
+
+// Canonical (interned) packs. The aggregate is keyed on the data member
+// descriptions sorted by name, hence every call site passing the same set of
+// (name, type) pairs - regardless of spelling or order - yields the same type.
+// Merged packs are interned the same way, keyed on their members in order.
+template <std::meta::info... Members>
+struct canonical_kwargs {
+  struct type;
+  consteval { define_aggregate(^^type, std::vector<std::meta::info>{Members...}); }
+};
+
+// argument indices sorted by name, this is the member order of canonical packs
+template <_kwargs_impl::fixed_string Names>
+consteval std::vector<std::size_t> canonical_order() {
+  auto parser = name_parser_for<Names>{Names};
+  if (!parser.parse()) {
+    return {};
+  }
+
+  std::vector<std::size_t> order;
+  for (std::size_t idx = 0; idx < parser.names.size(); ++idx) {
+    order.push_back(idx);
+  }
+  std::ranges::sort(order, {}, [&](std::size_t idx) { return parser.names[idx]; });
+  return order;
+}
+
+template <_kwargs_impl::fixed_string Names, typename... Ts>
+consteval std::meta::info canonical_type() {
+  std::vector<std::meta::info> types{^^Ts...};
+  auto parser = name_parser_for<Names>{Names};
+  if (!parser.parse() || parser.names.size() != types.size()) {
+    return {};
+  }
+
+  std::vector<std::meta::info> sorted_types;
+  std::vector<std::string_view> sorted_names;
+  for (auto idx : canonical_order<Names>()) {
+    sorted_types.push_back(types[idx]);
+    sorted_names.push_back(parser.names[idx]);
+  }
+
+  std::vector<std::meta::info> args;
+  for (auto spec : _kwargs_impl::pack_members(sorted_types, sorted_names)) {
+    args.push_back(std::meta::reflect_constant(spec));
+  }
+  return substitute(^^canonical_kwargs, args);
+}
+
+template <_kwargs_impl::fixed_string Names, typename... Ts>
+constexpr auto make_canonical(Ts&&... values) {
+  constexpr auto canonical = canonical_type<Names, Ts...>();
+  static_assert(canonical != std::meta::info{}, std::string{"Invalid keyword arguments `"} + Names + "`");
+
+  using kwargs_impl = typename[:canonical:]::type;
+  return [:_kwargs_impl::expand(_kwargs_impl::in_declaration_order<kwargs_impl>(canonical_order<Names>())):] >>
+         [&]<std::size_t... Idx> {
+    return kwargs_t<kwargs_impl>{{std::forward<Ts...[Idx]>(values...[Idx])...}};
+  };
+}
+
+template <_kwargs_impl::fixed_string Names, bool Canonical = false, typename... Ts>
+constexpr auto make(Ts&&... values) {
+  if constexpr (Canonical) {
+    return make_canonical<Names>(std::forward<Ts>(values)...);
+  } else {
+    struct kwargs_impl;
+    consteval {
+      std::vector<std::meta::info> types{^^Ts...};
+
+      auto parser = name_parser_for<Names>{Names};
+
+      // with P3068 parser.parse() could throw to provide better diagnostics at this point
+      if (!parser.parse()) {
+        return;
+      }
+
+      // associate every argument with the corresponding name
+      // retrieved by parsing the capture list
+      define_aggregate(^^kwargs_impl, _kwargs_impl::pack_members(types, parser.names));
+    };
+
+    // ensure injecting the class worked
+    static_assert(is_type(^^kwargs_impl), std::string{"Invalid keyword arguments `"} + Names + "`");
+
+    return [:_kwargs_impl::expand(_kwargs_impl::declaration_order<kwargs_impl>()):] >> [&]<std::size_t... Idx> {
+      return kwargs_t<kwargs_impl>{{std::forward<Ts...[Idx]>(values...[Idx])...}};
+    };
+  }
+}
+}  // namespace kwargs
+
+template <_kwargs_impl::fixed_string Names, typename... Ts>
+constexpr auto make_args(Ts&&... values) {
+  return kwargs::make<Names>(std::forward<Ts>(values)...);
+}
+
+// borrowing packs created by make_args_ref are regular kwargs_t whose members are all references
+template <typename T>
+concept is_kwargs_ref = is_kwargs<T> && _kwargs_impl::has_only_reference_members<typename T::type>();
+
+template <typename T>
+consteval bool has_arg(std::string_view name) {
+  if constexpr (is_kwargs<std::remove_cvref_t<T>>) {
+    return _kwargs_impl::has_member<typename std::remove_cvref_t<T>::type>(name);
+  } else {
+    return _kwargs_impl::has_member<T>(name);
+  }
+}
+
+// get
+// the member access is parenthesized so decltype(auto) yields a reference
+// carrying the value category of `kwargs`, like std::get on a tuple
+
+template <std::size_t I, typename T>
+  requires is_kwargs<std::remove_cvref_t<T>>
+constexpr decltype(auto) get(T&& kwargs) noexcept {
+  using kwarg_tuple = typename std::remove_cvref_t<T>::type;
+  static_assert(_kwargs_impl::member_count<kwarg_tuple> > I);
+
+  return (std::forward<T>(kwargs).[:_kwargs_impl::members<kwarg_tuple>[I]:]);
+}
+
+template <_kwargs_impl::fixed_string name, typename T>
+  requires is_kwargs<std::remove_cvref_t<T>>
+constexpr decltype(auto) get(T&& kwargs) {
+  using kwarg_tuple = typename std::remove_cvref_t<T>::type;
+  static_assert(_kwargs_impl::has_member<kwarg_tuple>(name), "Keyword argument `" + std::string(name) + "` not found.");
+
+  return (std::forward<T>(kwargs)
+              .[:_kwargs_impl::members<kwarg_tuple>[_kwargs_impl::get_member_index<kwarg_tuple>(name)]:]);
+}
+
+// get_or
+// returns a reference to the member if present. Otherwise lvalue defaults are
+// returned by reference and rvalue defaults are moved into the result.
+template <std::size_t I, typename T, typename R>
+  requires is_kwargs<std::remove_cvref_t<T>>
+constexpr decltype(auto) get_or(T&& kwargs, R&& default_) noexcept {
+  using kwarg_tuple = typename std::remove_cvref_t<T>::type;
+  if constexpr (_kwargs_impl::member_count<kwarg_tuple> > I) {
+    return get<I>(std::forward<T>(kwargs));
+  } else {
+    return static_cast<R>(std::forward<R>(default_));
+  }
+}
+
+template <_kwargs_impl::fixed_string name, typename T, typename R>
+  requires is_kwargs<std::remove_cvref_t<T>>
+constexpr decltype(auto) get_or(T&& kwargs, R&& default_) {
+  using kwarg_tuple = typename std::remove_cvref_t<T>::type;
+  if constexpr (_kwargs_impl::member_count<kwarg_tuple> > _kwargs_impl::get_member_index<kwarg_tuple>(name)) {
+    return get<name>(std::forward<T>(kwargs));
+  } else {
+    return static_cast<R>(std::forward<R>(default_));
+  }
+}
+
+namespace _kwargs_impl {
+struct merge_source {
+  std::size_t pack;
+  std::size_t member;
+};
+
+// For every name in the union of the packs' members (in order of first
+// appearance) the pack and member it is taken from. Later packs win.
+template <typename... Packs>
+consteval std::vector<merge_source> merge_plan() {
+  std::vector<std::meta::info> packs{^^Packs...};
+  std::vector<std::string_view> names;
+  std::vector<merge_source> sources;
+  for (std::size_t pack = 0; pack < packs.size(); ++pack) {
+    auto arguments = logical_members(packs[pack]);
+    for (std::size_t member = 0; member < arguments.size(); ++member) {
+      auto name = identifier_of(arguments[member]);
+      if (auto it = std::ranges::find(names, name); it != names.end()) {
+        sources[static_cast<std::size_t>(it - names.begin())] = {pack, member};
+      } else {
+        names.push_back(name);
+        sources.push_back({pack, member});
+      }
+    }
+  }
+  return sources;
+}
+
+// Merged packs own their members unless borrowing. Borrowed members refer to
+// the source members, references in the sources are kept as they are.
+template <bool Borrow, typename... Packs>
+consteval std::meta::info merge_type() {
+  std::vector<std::meta::info> packs{^^typename std::remove_cvref_t<Packs>::type...};
+  std::vector<std::meta::info> qualified{^^std::remove_reference_t<Packs>...};
+
+  std::vector<std::meta::info> types;
+  std::vector<std::string_view> names;
+  for (auto [pack, member] : merge_plan<typename std::remove_cvref_t<Packs>::type...>()) {
+    auto source = get_nth_member(packs[pack], member);
+    auto type   = type_of(source);
+    if (!Borrow) {
+      type = remove_cvref(type);
+    } else if (!is_reference_type(type)) {
+      type = add_lvalue_reference(is_const_type(qualified[pack]) ? add_const(type) : type);
+    }
+    types.push_back(type);
+    names.push_back(identifier_of(source));
+  }
+
+  std::vector<std::meta::info> args;
+  for (auto spec : pack_members(types, names)) {
+    args.push_back(std::meta::reflect_constant(spec));
+  }
+  return substitute(^^kwargs::canonical_kwargs, args);
+}
+
+template <bool Borrow, typename... Packs>
+constexpr auto merge(Packs&&... packs) {
+  using result = kwargs_t<typename[:merge_type<Borrow, Packs...>():]::type>;
+  constexpr static auto plan = std::define_static_array(
+      in_declaration_order<typename result::type>(merge_plan<typename std::remove_cvref_t<Packs>::type...>()));
+
+  return [:expand(plan):] >> [&]<merge_source... Sources> {
+    return result{{get<Sources.member>(std::forward<Packs...[Sources.pack]>(packs...[Sources.pack]))...}};
+  };
+}
+}  // namespace _kwargs_impl
+
+// Combines packs into one holding the union of their members, for names
+// present in several packs the last one wins. Members are moved out of rvalue
+// packs, overridden members are never touched.
+template <typename... Packs>
+  requires(sizeof...(Packs) > 0 && (is_kwargs<std::remove_cvref_t<Packs>> && ...))
+constexpr auto merge(Packs&&... packs) {
+  return _kwargs_impl::merge<false>(std::forward<Packs>(packs)...);
+}
+
+// Like merge, but the result only refers to the members of the source packs.
+template <typename... Packs>
+  requires(sizeof...(Packs) > 0 && (is_kwargs<std::remove_cvref_t<Packs>> && ...) &&
+           (std::is_lvalue_reference_v<Packs> && ...))
+constexpr auto merge_ref(Packs&&... packs) {
+  return _kwargs_impl::merge<true>(std::forward<Packs>(packs)...);
+}
+
+namespace _kwargs_impl {
+// FNV-1a
+constexpr std::uint64_t hash_name(std::string_view name) {
+  std::uint64_t hash = 0xcbf2'9ce4'8422'2325ULL;
+  for (char const chr : name) {
+    hash ^= static_cast<unsigned char>(chr);
+    hash *= 0x100'0000'01b3ULL;
+  }
+  return hash;
+}
+}  // namespace _kwargs_impl
+
+}  // namespace erl
+
+template <typename T>
+struct std::tuple_size<erl::kwargs_t<T>>
+    : public integral_constant<size_t, erl::_kwargs_impl::member_count<std::remove_cvref_t<T>>> {};
+
+template <std::size_t I, typename T>
+struct std::tuple_element<I, erl::kwargs_t<T>> {
+  using type = typename[:type_of(erl::_kwargs_impl::members<T>[I]):];
+};
+
+#include "macros.h"
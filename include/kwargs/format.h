@@ -0,0 +1,2204 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "config.h"
+
+// the erl.kwargs.format module imports the core instead
+#ifndef KWARGS_IMPORT_CORE
+#  include "core.h"
+#  include "stats.h"
+#endif
+
+#include <format>
+#include <print>
+#include <cstdio>
+#include <string>
+#include <iterator>
+#include <limits>
+#include <charconv>
+#include <optional>
+#include <cmath>
+#include <exception>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#if KWARGS_SINKS == 1
+#  include <atomic>
+#  include <cerrno>
+#  include <chrono>
+#  include <climits>
+#  include <condition_variable>
+#  include <mutex>
+#  include <ostream>
+#  include <stop_token>
+#  include <thread>
+#  if __has_include(<sys/uio.h>)
+#    include <sys/uio.h>
+#  endif
+#endif
+
+#if KWARGS_LOGGING == 1
+#  include <atomic>
+#  include <chrono>
+#  include <mutex>
+#  include <new>
+#  include <stop_token>
+#  include <thread>
+#endif
+
+KWARGS_EXPORT namespace erl {
+namespace formatting {
+// Element of a compiled format plan. Either literal text (already unescaped)
+// or a replacement field referring to the member at `index`. For fields `text`
+// holds the field as a single-argument format string, ie "{:>8}". Fields with
+// nested replacement fields in their spec (dynamic width or precision) use
+// manual indexing instead, ie. "{0:>{1}}", argument 1 being the member at
+// `nested[0]`.
+struct FormatSegment {
+  static constexpr std::size_t literal = -1UZ;
+
+  std::size_t index;
+  char const* text;
+  std::size_t size;
+  bool has_spec;
+  std::size_t nested[2]{};
+  std::size_t nested_count = 0;
+
+  [[nodiscard]] constexpr std::string_view view() const { return {text, size}; }
+};
+
+struct FmtParser : _kwargs_impl::Parser {
+  // Splits the format string into literal text and replacement fields.
+  // `on_literal` receives runs of text taken from the input as-is, that is
+  // with escaped braces still doubled. `on_field` receives the name and the
+  // format spec (without the leading ':') of every field and may abort by
+  // returning false. Fails on unmatched braces and, unless `nested` is set,
+  // on nested replacement fields. Those are passed on as part of the spec.
+  constexpr bool scan(auto&& on_literal, auto&& on_field, bool nested = false) {
+    std::size_t literal_start = 0;
+    auto flush_literal        = [&](std::size_t end) {
+      if (end > literal_start) {
+        on_literal(data.substr(literal_start, end - literal_start));
+      }
+    };
+
+    cursor = 0;
+    while (is_valid()) {
+      char const chr = current();
+      ++cursor;
+      if (chr == '}') {
+        if (!is_valid() || current() != '}') {
+          return false;
+        }
+        ++cursor;
+        continue;
+      } else if (chr != '{') {
+        continue;
+      }
+
+      if (is_valid() && current() == '{') {
+        ++cursor;
+        continue;
+      }
+
+      flush_literal(cursor - 1);
+
+      auto start = cursor;
+      while (is_valid() && current() != '}' && current() != ':') {
+        ++cursor;
+      }
+      auto name = data.substr(start, cursor - start);
+
+      std::string_view spec;
+      if (is_valid() && current() == ':') {
+        start = ++cursor;
+        while (is_valid() && current() != '}') {
+          if (current() == '{') {
+            if (!nested) {
+              return false;
+            }
+            while (is_valid() && current() != '}') {
+              ++cursor;
+            }
+            if (!is_valid()) {
+              return false;
+            }
+          }
+          ++cursor;
+        }
+        spec = data.substr(start, cursor - start);
+      }
+      if (!is_valid()) {
+        return false;
+      }
+      ++cursor;
+      literal_start = cursor;
+
+      if (!on_field(name, spec)) {
+        return false;
+      }
+    }
+    flush_literal(data.size());
+    return true;
+  }
+
+  // appends `text` as passed to scan's `on_literal` with escaped braces collapsed
+  static constexpr void unescape(std::string_view text, std::string& out) {
+    for (std::size_t idx = 0; idx < text.size(); ++idx) {
+      out += text[idx];
+      if (text[idx] == '{' || text[idx] == '}') {
+        ++idx;
+      }
+    }
+  }
+
+  // Compiles the format string into literal segments and replacement fields.
+  // Yields nothing if the string uses features a plan cannot express
+  // (automatic indexing, unknown names, more than two nested fields), in
+  // which case the caller must fall back to `transform`.
+  // Every literal is copied into static storage so that segments can be
+  // template arguments, only literals with escaped braces are unescaped into
+  // a temporary string first. Fields without a format spec share one static
+  // string.
+  consteval std::optional<std::vector<FormatSegment>> compile(std::ranges::input_range auto const& names) {
+    std::vector<FormatSegment> segments;
+    segments.reserve(data.size() + 1);
+
+    auto on_literal = [&](std::string_view text) {
+      if (text.find_first_of("{}") == std::string_view::npos) {
+        segments.push_back({FormatSegment::literal, std::define_static_string(text), text.size(), false});
+        return;
+      }
+      std::string unescaped;
+      unescaped.reserve(text.size());
+      unescape(text, unescaped);
+      segments.push_back({FormatSegment::literal, std::define_static_string(unescaped), unescaped.size(), false});
+    };
+
+    auto on_field = [&](std::string_view name, std::string_view spec) {
+      auto it = std::ranges::find(names, name);
+      if (it == std::ranges::end(names)) {
+        return false;
+      }
+      auto index = static_cast<std::size_t>(std::ranges::distance(std::ranges::begin(names), it));
+
+      if (spec.empty()) {
+        segments.push_back({index, std::define_static_string(std::string_view{"{}"}), 2, false});
+        return true;
+      }
+
+      FormatSegment segment{index, nullptr, 0, true};
+      std::string field;
+      field.reserve(spec.size() + 4);
+      field += spec.contains('{') ? "{0:" : "{:";
+      for (std::size_t pos = 0; pos < spec.size(); ++pos) {
+        if (spec[pos] != '{') {
+          field += spec[pos];
+          continue;
+        }
+        auto const end    = spec.find('}', pos);
+        auto const nested = std::ranges::find(names, spec.substr(pos + 1, end - pos - 1));
+        if (nested == std::ranges::end(names) || segment.nested_count == std::size(segment.nested)) {
+          return false;
+        }
+        segment.nested[segment.nested_count++] =
+            static_cast<std::size_t>(std::ranges::distance(std::ranges::begin(names), nested));
+        field += '{';
+        field += static_cast<char>('0' + segment.nested_count);
+        field += '}';
+        pos = end;
+      }
+      field += '}';
+      segment.text = std::define_static_string(field);
+      segment.size = field.size();
+      segments.push_back(segment);
+      return true;
+    };
+
+    if (!scan(on_literal, on_field, true)) {
+      return {};
+    }
+    return segments;
+  }
+
+  constexpr std::string transform(std::ranges::input_range auto const& names) {
+    std::string out;
+    // every replaced name grows by at most the digits of its index
+    out.reserve(data.size() + 16);
+
+    auto copied = cursor;
+    while (is_valid()) {
+      if (current() == '{') {
+        ++cursor;
+        if (current() == '{') {
+          // double curly braces means escaped curly braces
+          // => treat the content as text
+          // skip to first unbalanced }
+          // this will match the outer {
+          skip_to('}');
+          continue;
+        }
+
+        // find name
+        auto start = cursor;
+        skip_to('}', ':');
+        auto name = data.substr(start, cursor - start);
+
+        // replace name
+        auto it  = std::ranges::find(names, name);
+        auto idx = static_cast<std::size_t>(std::ranges::distance(std::ranges::begin(names), it));
+
+        char digits[20];
+        out.append(data.substr(copied, start - copied));
+        out.append(digits, _kwargs_impl::write_decimal(digits, idx));
+        copied = cursor;
+      }
+      ++cursor;
+    }
+    out.append(data.substr(copied));
+    return out;
+  }
+};
+
+// Output buffer all named formatting functions write into. Writes go to a
+// contiguous region, the `grow` callback only runs once that is exhausted.
+// Depending on the concrete buffer it either makes room by reallocating or by
+// flushing the current contents to the destination.
+class Buffer {
+public:
+  using grow_type = void (*)(Buffer&, std::size_t);
+
+  struct iterator {
+    using difference_type = std::ptrdiff_t;
+    Buffer* buffer;
+
+    constexpr iterator& operator=(char chr) {
+      buffer->push_back(chr);
+      return *this;
+    }
+    constexpr iterator& operator*() { return *this; }
+    constexpr iterator& operator++() { return *this; }
+    constexpr iterator operator++(int) { return *this; }
+  };
+
+  Buffer(Buffer const&)            = delete;
+  Buffer& operator=(Buffer const&) = delete;
+
+  constexpr void push_back(char chr) {
+    if (size_ == capacity_) {
+      grow_(*this, size_ + 1);
+    }
+    data_[size_++] = chr;
+  }
+
+  constexpr void append(std::string_view str) {
+    while (!str.empty()) {
+      if (size_ == capacity_) {
+        grow_(*this, size_ + str.size());
+      }
+      auto count = std::min(str.size(), capacity_ - size_);
+      std::char_traits<char>::copy(data_ + size_, str.data(), count);
+      size_ += count;
+      str.remove_prefix(count);
+    }
+  }
+
+  [[nodiscard]] constexpr iterator out() { return {this}; }
+  [[nodiscard]] constexpr char* data() const { return data_; }
+  [[nodiscard]] constexpr std::size_t size() const { return size_; }
+  // characters written since construction, including flushed ones
+  [[nodiscard]] constexpr std::size_t written() const { return flushed_ + size_; }
+
+protected:
+  constexpr Buffer(grow_type grow, char* data, std::size_t capacity, std::size_t size = 0)
+      : data_(data)
+      , size_(size)
+      , capacity_(capacity)
+      , grow_(grow) {}
+
+  constexpr void set(char* data, std::size_t capacity) {
+    data_     = data;
+    capacity_ = capacity;
+  }
+  constexpr void clear() {
+    flushed_ += size_;
+    size_ = 0;
+  }
+
+private:
+  char* data_;
+  std::size_t size_;
+  std::size_t flushed_ = 0;
+  std::size_t capacity_;
+  grow_type grow_;
+};
+
+// appends to a std::string, the string is truncated to the written size on destruction
+class StringBuffer : public Buffer {
+  std::string& str;
+
+  static constexpr void grow(Buffer& self, std::size_t required) {
+    auto& buffer = static_cast<StringBuffer&>(self);
+    buffer.str.resize(std::max({required, buffer.str.size() * 2, std::size_t{64}}));
+    buffer.set(buffer.str.data(), buffer.str.size());
+  }
+
+public:
+  constexpr explicit StringBuffer(std::string& str)
+      : Buffer(&grow, str.data(), str.size(), str.size())
+      , str(str) {}
+  constexpr ~StringBuffer() { str.resize(size()); }
+};
+
+// writes to a FILE* in chunks, the remainder is flushed on destruction
+class FileBuffer : public Buffer {
+  std::FILE* stream;
+  char storage[512];
+
+  static void on_full(Buffer& self, std::size_t) { static_cast<FileBuffer&>(self).flush(); }
+
+public:
+  explicit FileBuffer(std::FILE* stream)
+      : Buffer(&on_full, storage, sizeof storage)
+      , stream(stream) {}
+  ~FileBuffer() { flush(); }
+
+  void flush() {
+    std::fwrite(data(), 1, size(), stream);
+    clear();
+  }
+};
+
+// holds the lock of a FILE* so that the chunks of one call are not interleaved
+// with output of other threads
+class StreamLock {
+  std::FILE* stream;
+
+public:
+  explicit StreamLock(std::FILE* stream)
+      : stream(stream) {
+    ::flockfile(stream);
+  }
+  ~StreamLock() { ::funlockfile(stream); }
+
+  StreamLock(StreamLock const&)            = delete;
+  StreamLock& operator=(StreamLock const&) = delete;
+};
+
+// writes to an arbitrary output iterator, optionally stopping after `limit` characters
+template <typename Out>
+class IteratorBuffer : public Buffer {
+  using difference_type = std::iter_difference_t<Out>;
+
+  Out target;
+  difference_type remaining;
+  difference_type written = 0;
+  char storage[256];
+
+  static constexpr void on_full(Buffer& self, std::size_t) { static_cast<IteratorBuffer&>(self).flush(); }
+
+  constexpr void flush() {
+    auto size = static_cast<difference_type>(this->size());
+    auto n    = std::min(size, remaining);
+    target    = std::ranges::copy_n(data(), n, std::move(target)).out;
+    remaining -= n;
+    written += size;
+    clear();
+  }
+
+public:
+  constexpr explicit IteratorBuffer(Out out, difference_type limit = std::numeric_limits<difference_type>::max())
+      : Buffer(&on_full, storage, sizeof storage)
+      , target(std::move(out))
+      , remaining(std::max(limit, difference_type{0})) {}
+
+  constexpr std::format_to_n_result<Out> finish() && {
+    flush();
+    return {std::move(target), written};
+  }
+};
+
+// discards everything, only counts characters
+class CountingBuffer : public Buffer {
+  std::size_t count_ = 0;
+  char storage[128];
+
+  static constexpr void on_full(Buffer& self, std::size_t) {
+    auto& buffer = static_cast<CountingBuffer&>(self);
+    buffer.count_ += buffer.size();
+    buffer.clear();
+  }
+
+public:
+  constexpr CountingBuffer() : Buffer(&on_full, storage, sizeof storage) {}
+  [[nodiscard]] constexpr std::size_t count() const { return count_ + size(); }
+};
+
+template <_kwargs_impl::fixed_string fmt, typename Args>
+void format_impl(Buffer& buffer, Args const& kwargs) {
+  [:_kwargs_impl::sequence(std::tuple_size_v<Args>):] >> [&]<std::size_t... Idx>() {
+    std::format_to(buffer.out(), fmt, get<Idx>(kwargs)...);
+  };
+}
+
+template <typename T>
+concept is_fast_string = std::same_as<T, std::string> || std::same_as<T, std::string_view> ||
+                         std::same_as<T, char const*> || std::same_as<T, char*>;
+
+// types whose default formatting can be written without going through std::format
+template <typename T>
+concept is_fast_formattable =
+    std::same_as<T, bool> || std::same_as<T, char> || std::floating_point<T> || is_fast_string<T> ||
+    (std::integral<T> && !std::same_as<T, wchar_t> && !std::same_as<T, char8_t> && !std::same_as<T, char16_t> &&
+     !std::same_as<T, char32_t>);
+
+// writes `value` exactly as std::format("{}", value) would
+template <is_fast_formattable T>
+constexpr void write_value(Buffer& buffer, T const& value) {
+  if constexpr (std::same_as<T, bool>) {
+    buffer.append(value ? "true" : "false");
+  } else if constexpr (std::same_as<T, char>) {
+    buffer.push_back(value);
+  } else if constexpr (is_fast_string<T>) {
+    buffer.append(std::string_view{value});
+  } else {
+    char storage[64];
+    auto result = std::to_chars(storage, storage + sizeof storage, value);
+    buffer.append({storage, result.ptr});
+  }
+}
+
+// formatter of a field, parsed by spec_formatter
+template <typename T>
+struct Preparsed {
+  std::formatter<T, char> const& formatter;
+  T const& value;
+};
+
+template <FormatSegment Segment, typename T>
+constexpr std::formatter<T, char> parse_spec() {
+  // the spec starts after the colon and ends at the closing brace, fields without one have none
+  constexpr auto colon = Segment.view().find(':');
+  std::formatter<T, char> formatter;
+  std::format_parse_context context{colon == std::string_view::npos ? std::string_view{}
+                                                                    : Segment.view().substr(colon + 1)};
+  formatter.parse(context);
+  return formatter;
+}
+
+template <FormatSegment Segment, typename T>
+concept is_constant_spec = requires { typename std::integral_constant<bool, (parse_spec<Segment, T>(), true)>; };
+
+// The formatter of a field parsed once, at compile time unless the formatter
+// cannot be parsed during constant evaluation (non-literal formatters and
+// nested replacement fields, whose argument ids are checked against the
+// argument count then) and on the first call otherwise.
+template <FormatSegment Segment, typename T>
+std::formatter<T, char> const& spec_formatter() {
+  if constexpr (is_constant_spec<Segment, T>) {
+    static constexpr std::formatter<T, char> formatter = parse_spec<Segment, T>();
+    return formatter;
+  } else {
+    static std::formatter<T, char> const formatter = parse_spec<Segment, T>();
+    return formatter;
+  }
+}
+
+// `nested` are the values of the nested replacement fields of Segment
+template <FormatSegment Segment, typename T, typename... Nested>
+constexpr void write_field(Buffer& buffer, T const& value, Nested const&... nested) {
+  if constexpr (!Segment.has_spec && is_fast_formattable<T>) {
+    write_value(buffer, value);
+  } else {
+    // rejects the spec at compile time just as formatting with Segment.text would
+    static_assert((std::format_string<T const&, Nested const&...>{Segment.view()}, true));
+    // A format context cannot be created directly. The only field of "{}" hands
+    // the context to the stored formatter, which finds the nested values at
+    // the argument ids it parsed.
+    std::format_to(buffer.out(), "{}", Preparsed<T>{spec_formatter<Segment, T>(), value}, nested...);
+  }
+}
+
+template <typename Args, FormatSegment... Segments>
+constexpr void plan_impl(Buffer& buffer, Args const& kwargs) {
+  (
+      [&] {
+        if constexpr (Segments.index == FormatSegment::literal) {
+          buffer.append(Segments.view());
+        } else {
+          [:_kwargs_impl::sequence(Segments.nested_count):] >> [&]<std::size_t... Idx> {
+            write_field<Segments>(buffer, get<Segments.index>(kwargs), get<Segments.nested[Idx]>(kwargs)...);
+          };
+        }
+      }(),
+      ...);
+}
+
+// fields that write_value can format during constant evaluation
+template <typename Args, FormatSegment Segment>
+consteval bool is_constant_field() {
+  if constexpr (Segment.index == FormatSegment::literal) {
+    return true;
+  } else {
+    using T = std::remove_cvref_t<decltype(get<Segment.index>(std::declval<Args const&>()))>;
+    return !Segment.has_spec && is_fast_formattable<T> && !std::floating_point<T>;
+  }
+}
+
+// plan_impl for `fmt` if every field can be formatted at compile time, nullptr otherwise
+template <_kwargs_impl::fixed_string fmt, typename Args>
+consteval auto constant_plan() -> void (*)(Buffer&, Args const&) {
+  auto plan = FmtParser{fmt}.compile(_kwargs_impl::get_member_names<typename Args::type>());
+  if (!plan) {
+    return nullptr;
+  }
+  std::vector<std::meta::info> args{^^Args};
+  for (auto const& segment : *plan) {
+    if (!extract<bool>(substitute(^^is_constant_field, {^^Args, std::meta::reflect_constant(segment)}))) {
+      return nullptr;
+    }
+    args.push_back(std::meta::reflect_constant(segment));
+  }
+  return extract<void (*)(Buffer&, Args const&)>(substitute(^^plan_impl, args));
+}
+
+// Upper bound for the default formatting of T, 0 if there is none. Floating
+// point values use the shortest round-trip representation, the longest
+// of which is a negative subnormal with a three digit exponent.
+template <typename T>
+consteval std::size_t max_formatted_size() {
+  if constexpr (std::same_as<T, bool>) {
+    return 5;
+  } else if constexpr (std::same_as<T, char>) {
+    return 1;
+  } else if constexpr (std::same_as<T, float>) {
+    return 15;
+  } else if constexpr (std::same_as<T, double>) {
+    return 24;
+  } else if constexpr (is_fast_formattable<T> && std::integral<T>) {
+    return std::numeric_limits<T>::digits10 + 1 + std::is_signed_v<T>;
+  } else {
+    return 0;
+  }
+}
+
+// Upper bound for the output of `fmt`, 0 if some field is unbounded. Fields
+// with a format spec are unbounded.
+template <_kwargs_impl::fixed_string fmt, typename Args>
+consteval std::size_t max_output_size() {
+  auto plan = FmtParser{fmt}.compile(_kwargs_impl::get_member_names<typename Args::type>());
+  if (!plan) {
+    return 0;
+  }
+  std::size_t total = 0;
+  for (auto const& segment : *plan) {
+    if (segment.index == FormatSegment::literal) {
+      total += segment.size;
+      continue;
+    }
+    if (segment.has_spec) {
+      return 0;
+    }
+    auto type  = remove_cvref(type_of(_kwargs_impl::members<typename Args::type>[segment.index]));
+    auto bound = extract<std::size_t>(substitute(^^max_formatted_size, {type}));
+    if (bound == 0) {
+      return 0;
+    }
+    total += bound;
+  }
+  return total;
+}
+
+// Formatted text stored inline, returned by erl::format_inline.
+template <std::size_t N>
+class InlineString {
+  std::size_t size_ = 0;
+  bool truncated_   = false;
+  char data_[N + 1];
+
+  template <std::size_t>
+  friend class InlineBuffer;
+
+public:
+  static constexpr std::size_t capacity = N;
+
+  [[nodiscard]] constexpr char const* data() const { return data_; }
+  [[nodiscard]] constexpr char const* c_str() const { return data_; }
+  [[nodiscard]] constexpr std::size_t size() const { return size_; }
+  // output was cut off at `capacity`, only possible with an explicit capacity
+  [[nodiscard]] constexpr bool truncated() const { return truncated_; }
+  [[nodiscard]] constexpr std::string_view view() const { return {data_, size_}; }
+  constexpr explicit(false) operator std::string_view() const { return view(); }
+};
+
+// writes into an InlineString, output beyond its capacity is discarded
+template <std::size_t N>
+class InlineBuffer : public Buffer {
+  InlineString<N>& target;
+  char discard[64];
+
+  static constexpr void on_full(Buffer& self, std::size_t) {
+    auto& buffer = static_cast<InlineBuffer&>(self);
+    if (!buffer.target.truncated_) {
+      buffer.target.size_      = buffer.size();
+      buffer.target.truncated_ = true;
+    }
+    buffer.set(buffer.discard, sizeof buffer.discard);
+    buffer.clear();
+  }
+
+public:
+  constexpr explicit InlineBuffer(InlineString<N>& target)
+      : Buffer(&on_full, target.data_, N)
+      , target(target) {}
+  constexpr ~InlineBuffer() {
+    if (!target.truncated_) {
+      target.size_ = size();
+    }
+    target.data_[target.size_] = '\0';
+  }
+};
+
+// Result of erl::static_format. Refers to a static string if formatting
+// happened during constant evaluation, owns the formatted string otherwise.
+class StaticFormatResult {
+  std::string_view text;
+  std::string owned;
+
+public:
+  constexpr explicit StaticFormatResult(std::string_view text) : text(text) {}
+  constexpr explicit StaticFormatResult(std::string owned) : owned(std::move(owned)) {}
+
+  [[nodiscard]] constexpr bool is_static() const { return owned.empty() && text.data() != nullptr; }
+  [[nodiscard]] constexpr std::string_view view() const { return owned.empty() ? text : std::string_view{owned}; }
+  constexpr explicit(false) operator std::string_view() const { return view(); }
+};
+
+#if KWARGS_STATS == 1
+template <typename Args,
+          auto Emit,
+          char const* Fmt,
+          char const* File,
+          char const* Function,
+          std::uint_least32_t Line,
+          std::uint_least32_t Column>
+void counted_emit(Buffer& buffer, Args const& kwargs) {
+  _kwargs_impl::stats_scope scope{
+      _kwargs_impl::stats_site_for<stats::kind::format, Fmt, File, Function, Line, Column>};
+  auto const start = buffer.written();
+  Emit(buffer, kwargs);
+  scope.bytes = buffer.written() - start;
+}
+#endif
+
+template <typename Args>
+struct NamedFormatString {
+  // generic entry point, writes the formatted output to `buffer`
+  using emit_type = void (*)(Buffer&, Args const&);
+  emit_type emit;
+
+  // The format string is compiled into a plan of literal segments and typed
+  // replacement fields. Literals are copied as-is, fields of common types with
+  // default formatting are written directly and all other fields by a
+  // std::formatter whose spec was parsed once. The whole string only goes
+  // through std::format if it cannot be compiled, which reports the error.
+  template <typename Tp>
+    requires std::convertible_to<Tp const&, std::string_view>
+#if KWARGS_STATS == 1
+  consteval explicit(false) NamedFormatString(Tp const& str,
+                                              std::source_location where = std::source_location::current()) {
+#else
+  consteval explicit(false) NamedFormatString(Tp const& str) {
+#endif
+    emit = compile(str);
+#if KWARGS_STATS == 1
+    // every call site gets its own counters
+    auto text = [](std::string_view value) { return std::meta::reflect_constant(std::define_static_string(value)); };
+    emit      = extract<emit_type>(substitute(^^counted_emit,
+                                              {^^Args,
+                                               std::meta::reflect_constant(emit),
+                                               text(str),
+                                               text(where.file_name()),
+                                               text(where.function_name()),
+                                               std::meta::reflect_constant(where.line()),
+                                               std::meta::reflect_constant(where.column())}));
+#endif
+  }
+
+  // the emit function without call site counters
+  static consteval emit_type compile(std::string_view str) {
+    auto names = _kwargs_impl::get_member_names<typename Args::type>();
+    if (auto plan = FmtParser{str}.compile(names)) {
+      std::vector<std::meta::info> args{^^Args};
+      for (auto const& segment : *plan) {
+        args.push_back(std::meta::reflect_constant(segment));
+      }
+      return extract<emit_type>(substitute(^^plan_impl, args));
+    }
+    auto fmt = FmtParser{str}.transform(names);
+    return extract<emit_type>(substitute(^^format_impl, {std::meta::reflect_constant_string(fmt), ^^Args}));
+  }
+
+  [[nodiscard]] std::string format(Args const& kwargs) const {
+    std::string out;
+    {
+      StringBuffer buffer{out};
+      emit(buffer, kwargs);
+    }
+    return out;
+  }
+};
+
+// Named format string parsed at runtime, ie. loaded from configuration. Names
+// are resolved once on construction, every field keeps a pointer to the
+// writer for its argument. The template is immutable afterwards and can be
+// shared between threads.
+template <typename Args>
+class CompiledTemplate {
+  using writer_type = void (*)(Buffer&, Args const&, std::string_view);
+
+  // literals have no writer, for fields `text` is the single-argument format string
+  struct Segment {
+    writer_type write;
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  std::string storage;
+  std::vector<Segment> segments;
+
+  template <std::size_t I>
+  static void write_member(Buffer& buffer, Args const& kwargs, std::string_view fmt) {
+    auto const& value = get<I>(kwargs);
+    using T           = std::remove_cvref_t<decltype(value)>;
+    if constexpr (is_fast_formattable<T>) {
+      if (fmt.size() == 2) {
+        write_value(buffer, value);
+        return;
+      }
+    }
+    std::vformat_to(buffer.out(), fmt, std::make_format_args(value));
+  }
+
+  // nullptr for arguments that cannot be formatted
+  template <std::size_t I>
+  static consteval writer_type writer_for() {
+    if constexpr (std::formattable<std::remove_cvref_t<decltype(get<I>(std::declval<Args const&>()))>, char>) {
+      return &write_member<I>;
+    } else {
+      return nullptr;
+    }
+  }
+
+  static constexpr auto writers = [:_kwargs_impl::sequence(std::tuple_size_v<Args>):] >> []<std::size_t... Idx> {
+    return std::array<writer_type, sizeof...(Idx)>{writer_for<Idx>()...};
+  };
+
+  // runs the format spec through the argument's formatter, throws std::format_error if it is invalid
+  template <std::size_t I>
+  static void check_spec(std::string_view spec) {
+    using T = std::remove_cvref_t<decltype(get<I>(std::declval<Args const&>()))>;
+    if constexpr (std::formattable<T, char>) {
+      std::formatter<T, char> formatter;
+      std::format_parse_context context{spec};
+      if (formatter.parse(context) != context.end()) {
+        throw std::format_error("unexpected characters in format spec");
+      }
+    }
+  }
+
+  static constexpr auto spec_checks = [:_kwargs_impl::sequence(std::tuple_size_v<Args>):] >>
+                                      []<std::size_t... Idx> {
+                                        return std::array<void (*)(std::string_view), sizeof...(Idx)>{
+                                            &check_spec<Idx>...};
+                                      };
+
+public:
+  // throws std::format_error on malformed templates, unknown or unformattable
+  // arguments and format specs the argument's formatter rejects
+  explicit CompiledTemplate(std::string_view fmt) {
+    auto names = _kwargs_impl::get_member_names<typename Args::type>();
+    std::string error;
+    std::string_view failed_name;
+
+    auto on_literal = [&](std::string_view text) {
+      auto offset = storage.size();
+      FmtParser::unescape(text, storage);
+      segments.push_back({nullptr, offset, storage.size() - offset});
+    };
+    auto on_field = [&](std::string_view name, std::string_view spec) {
+      auto it = std::ranges::find(names, name);
+      if (it == std::ranges::end(names)) {
+        error       = "unknown keyword argument";
+        failed_name = name;
+        return false;
+      }
+      auto const index = static_cast<std::size_t>(std::ranges::distance(std::ranges::begin(names), it));
+      auto write       = writers[index];
+      if (write == nullptr) {
+        error       = "keyword argument is not formattable";
+        failed_name = name;
+        return false;
+      }
+      if (!spec.empty()) {
+        try {
+          spec_checks[index](spec);
+        } catch (std::format_error const& spec_error) {
+          error       = "invalid format spec `" + std::string(spec) + "` (" + spec_error.what() + ") for";
+          failed_name = name;
+          return false;
+        }
+      }
+
+      auto offset = storage.size();
+      if (spec.empty()) {
+        storage += "{}";
+      } else {
+        storage += "{:";
+        storage += spec;
+        storage += '}';
+      }
+      segments.push_back({write, offset, storage.size() - offset});
+      return true;
+    };
+
+    if (!FmtParser{fmt}.scan(on_literal, on_field)) {
+      if (error.empty()) {
+        throw std::format_error("Invalid named format string `" + std::string(fmt) + "`");
+      }
+      throw std::format_error("In named format string `" + std::string(fmt) + "`: " + error + " `" +
+                              std::string(failed_name) + "`");
+    }
+  }
+
+  void emit(Buffer& buffer, Args const& kwargs) const {
+    for (auto const& segment : segments) {
+      std::string_view text{storage.data() + segment.offset, segment.size};
+      if (segment.write == nullptr) {
+        buffer.append(text);
+      } else {
+        segment.write(buffer, kwargs, text);
+      }
+    }
+  }
+
+  [[nodiscard]] std::string format(Args const& kwargs) const {
+    std::string out;
+    {
+      StringBuffer buffer{out};
+      emit(buffer, kwargs);
+    }
+    return out;
+  }
+
+  template <std::output_iterator<char const&> Out>
+  Out format_to(Out out, Args const& kwargs) const {
+    IteratorBuffer<Out> buffer{std::move(out)};
+    emit(buffer, kwargs);
+    return std::move(buffer).finish().out;
+  }
+
+  [[nodiscard]] std::size_t formatted_size(Args const& kwargs) const {
+    CountingBuffer buffer;
+    emit(buffer, kwargs);
+    return buffer.count();
+  }
+};
+
+// Structured output. Keys are identifiers, their text including quotes and
+// separators is generated at compile time and written with a single append.
+consteval std::string_view static_text(std::string const& text) {
+  return {std::define_static_string(text), text.size()};
+}
+
+template <typename T>
+constexpr inline auto json_keys = [:_kwargs_impl::sequence(_kwargs_impl::member_count<T>):] >>
+                                  []<std::size_t... Idx> {
+                                    return std::array<std::string_view, sizeof...(Idx)>{static_text(
+                                        (Idx == 0 ? "{\"" : ",\"") +
+                                        std::string{identifier_of(_kwargs_impl::members<T>[Idx])} + "\":")...};
+                                  };
+
+template <typename T>
+constexpr inline auto logfmt_keys = [:_kwargs_impl::sequence(_kwargs_impl::member_count<T>):] >>
+                                    []<std::size_t... Idx> {
+                                      return std::array<std::string_view, sizeof...(Idx)>{
+                                          static_text(std::string{identifier_of(_kwargs_impl::members<T>[Idx])})...};
+                                    };
+
+// characters that must be escaped within a quoted string, for logfmt also
+// those that require quoting in the first place
+template <bool Logfmt>
+constexpr bool is_special(char chr) {
+  auto const byte = static_cast<unsigned char>(chr);
+  return byte < 0x20 || chr == '"' || chr == '\\' || (Logfmt && (chr == ' ' || chr == '='));
+}
+
+// Index of the first special character, `str.size()` if there is none.
+// Outside of constant evaluation eight characters are tested at once.
+template <bool Logfmt>
+constexpr std::size_t find_special(std::string_view str) {
+  std::size_t idx = 0;
+  if !consteval {
+    if constexpr (std::endian::native == std::endian::little) {
+      constexpr std::uint64_t ones = 0x0101'0101'0101'0101ULL;
+      constexpr std::uint64_t high = 0x8080'8080'8080'8080ULL;
+      // sets the high bit of the first zero byte, bits above it may be false positives
+      auto zero_bytes = [](std::uint64_t word) { return (word - ones) & ~word & high; };
+
+      for (; idx + 8 <= str.size(); idx += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, str.data() + idx, sizeof word);
+        auto mask = ((word - ones * 0x20) & ~word & high) | zero_bytes(word ^ (ones * '"')) |
+                    zero_bytes(word ^ (ones * '\\'));
+        if constexpr (Logfmt) {
+          mask |= zero_bytes(word ^ (ones * ' ')) | zero_bytes(word ^ (ones * '='));
+        }
+        if (mask != 0) {
+          return idx + static_cast<std::size_t>(std::countr_zero(mask)) / 8;
+        }
+      }
+    }
+  }
+  for (; idx < str.size(); ++idx) {
+    if (is_special<Logfmt>(str[idx])) {
+      return idx;
+    }
+  }
+  return str.size();
+}
+
+// writes `str` quoted, escaping as JSON does
+inline void write_quoted(Buffer& buffer, std::string_view str) {
+  buffer.push_back('"');
+  while (true) {
+    auto pos = find_special<false>(str);
+    buffer.append(str.substr(0, pos));
+    if (pos == str.size()) {
+      break;
+    }
+
+    switch (char const chr = str[pos]) {
+      case '"': buffer.append("\\\""); break;
+      case '\\': buffer.append("\\\\"); break;
+      case '\n': buffer.append("\\n"); break;
+      case '\r': buffer.append("\\r"); break;
+      case '\t': buffer.append("\\t"); break;
+      case '\b': buffer.append("\\b"); break;
+      case '\f': buffer.append("\\f"); break;
+      default: {
+        constexpr char hex[] = "0123456789abcdef";
+        auto const byte      = static_cast<unsigned char>(chr);
+        char escaped[]       = {'\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 0xF]};
+        buffer.append({escaped, sizeof escaped});
+      }
+    }
+    str.remove_prefix(pos + 1);
+  }
+  buffer.push_back('"');
+}
+
+template <typename T>
+constexpr inline bool is_optional = false;
+template <typename T>
+constexpr inline bool is_optional<std::optional<T>> = true;
+
+template <typename T>
+void write_json(Buffer& buffer, T const& value);
+
+template <typename T>
+void write_json_object(Buffer& buffer, T const& kwargs) {
+  using impl = typename T::type;
+  if constexpr (_kwargs_impl::member_count<impl> == 0) {
+    buffer.append("{}");
+  } else {
+    [:_kwargs_impl::sequence(_kwargs_impl::member_count<impl>):] >>= [&]<std::size_t Idx> {
+      buffer.append(json_keys<impl>[Idx]);
+      write_json(buffer, get<Idx>(kwargs));
+    };
+    buffer.push_back('}');
+  }
+}
+
+template <typename T>
+void write_json(Buffer& buffer, T const& value) {
+  if constexpr (is_kwargs<T>) {
+    write_json_object(buffer, value);
+  } else if constexpr (std::same_as<T, char>) {
+    write_quoted(buffer, {&value, 1});
+  } else if constexpr (std::integral<T> && is_fast_formattable<T>) {
+    write_value(buffer, value);
+  } else if constexpr (std::floating_point<T>) {
+    if (std::isfinite(value)) {
+      write_value(buffer, value);
+    } else {
+      buffer.append("null");
+    }
+  } else if constexpr (std::same_as<T, char const*> || std::same_as<T, char*>) {
+    if (value == nullptr) {
+      buffer.append("null");
+    } else {
+      write_quoted(buffer, value);
+    }
+  } else if constexpr (is_fast_string<T>) {
+    write_quoted(buffer, value);
+  } else if constexpr (std::same_as<T, std::nullptr_t>) {
+    buffer.append("null");
+  } else if constexpr (is_optional<T>) {
+    if (value) {
+      write_json(buffer, *value);
+    } else {
+      buffer.append("null");
+    }
+  } else if constexpr (std::ranges::input_range<T const>) {
+    buffer.push_back('[');
+    bool first = true;
+    for (auto const& item : value) {
+      if (!std::exchange(first, false)) {
+        buffer.push_back(',');
+      }
+      write_json(buffer, item);
+    }
+    buffer.push_back(']');
+  } else {
+    static_assert(std::formattable<T, char>, "Keyword argument type cannot be written as JSON");
+    std::string text;
+    {
+      StringBuffer formatted{text};
+      std::format_to(formatted.out(), "{}", value);
+    }
+    write_quoted(buffer, text);
+  }
+}
+
+// strings are only quoted if they are empty or contain spaces, '=', quotes or control characters
+inline void write_logfmt_string(Buffer& buffer, std::string_view str) {
+  if (!str.empty() && find_special<true>(str) == str.size()) {
+    buffer.append(str);
+  } else {
+    write_quoted(buffer, str);
+  }
+}
+
+// nested packs are flattened, their keys are prefixed with the parent key and '.'
+template <typename T>
+void write_logfmt_object(Buffer& buffer, T const& kwargs, std::string_view prefix, bool& first) {
+  using impl = typename T::type;
+  [:_kwargs_impl::sequence(_kwargs_impl::member_count<impl>):] >>= [&]<std::size_t Idx> {
+    auto const& value = get<Idx>(kwargs);
+    using V           = std::remove_cvref_t<decltype(value)>;
+    if constexpr (is_kwargs<V>) {
+      std::string nested{prefix};
+      nested += logfmt_keys<impl>[Idx];
+      nested += '.';
+      write_logfmt_object(buffer, value, nested, first);
+    } else {
+      if (!std::exchange(first, false)) {
+        buffer.push_back(' ');
+      }
+      buffer.append(prefix);
+      buffer.append(logfmt_keys<impl>[Idx]);
+      buffer.push_back('=');
+
+      if constexpr (std::same_as<V, char>) {
+        write_logfmt_string(buffer, {&value, 1});
+      } else if constexpr ((std::integral<V> || std::floating_point<V>) && is_fast_formattable<V>) {
+        write_value(buffer, value);
+      } else if constexpr (std::same_as<V, char const*> || std::same_as<V, char*>) {
+        write_logfmt_string(buffer, value == nullptr ? std::string_view{} : std::string_view{value});
+      } else if constexpr (is_fast_string<V>) {
+        write_logfmt_string(buffer, value);
+      } else if constexpr (is_optional<V>) {
+        if (value) {
+          write_logfmt_string(buffer, std::format("{}", *value));
+        }
+      } else {
+        static_assert(std::formattable<V, char>, "Keyword argument type cannot be written as logfmt");
+        std::string text;
+        {
+          StringBuffer formatted{text};
+          std::format_to(formatted.out(), "{}", value);
+        }
+        write_logfmt_string(buffer, text);
+      }
+    }
+  };
+}
+
+template <typename T>
+void write_logfmt(Buffer& buffer, T const& kwargs) {
+  bool first = true;
+  write_logfmt_object(buffer, kwargs, {}, first);
+}
+}  // namespace formatting
+
+// Compiles a named format string that is only known at runtime for packs of type Args.
+template <typename Args>
+  requires(is_kwargs<Args>)
+formatting::CompiledTemplate<Args> compile_template(std::string_view fmt) {
+  return formatting::CompiledTemplate<Args>{fmt};
+}
+
+// Writes the pack as a JSON object. Nested packs become nested objects,
+// ranges arrays and empty optionals null. Other types are written as the
+// string std::format produces for them.
+template <typename T>
+  requires(is_kwargs<T>)
+std::string to_json(T const& kwargs) {
+  std::string out;
+  {
+    formatting::StringBuffer buffer{out};
+    formatting::write_json(buffer, kwargs);
+  }
+  return out;
+}
+
+template <std::output_iterator<char const&> Out, typename T>
+  requires(is_kwargs<T>)
+Out to_json(Out out, T const& kwargs) {
+  formatting::IteratorBuffer<Out> buffer{std::move(out)};
+  formatting::write_json(buffer, kwargs);
+  return std::move(buffer).finish().out;
+}
+
+// Writes the pack as logfmt (`key=value key2="quoted value"`). Keys of
+// nested packs are joined with '.', empty optionals are written as `key=`.
+template <typename T>
+  requires(is_kwargs<T>)
+std::string to_logfmt(T const& kwargs) {
+  std::string out;
+  {
+    formatting::StringBuffer buffer{out};
+    formatting::write_logfmt(buffer, kwargs);
+  }
+  return out;
+}
+
+template <std::output_iterator<char const&> Out, typename T>
+  requires(is_kwargs<T>)
+Out to_logfmt(Out out, T const& kwargs) {
+  formatting::IteratorBuffer<Out> buffer{std::move(out)};
+  formatting::write_logfmt(buffer, kwargs);
+  return std::move(buffer).finish().out;
+}
+
+template <typename T>
+using named_format_string = formatting::NamedFormatString<std::type_identity_t<T>>;
+
+template <typename T>
+  requires(is_kwargs<T>)
+void print(std::FILE* stream, erl::named_format_string<T> fmt, T const& kwargs) {
+  formatting::StreamLock lock{stream};
+  formatting::FileBuffer buffer{stream};
+  fmt.emit(buffer, kwargs);
+}
+
+template <typename T>
+  requires(is_kwargs<T>)
+void print(erl::named_format_string<T> fmt, T const& kwargs) {
+  erl::print(stdout, fmt, kwargs);
+}
+
+template <typename... Args>
+  requires(sizeof...(Args) != 1 || (!is_kwargs<std::remove_cvref_t<Args>> && ...))
+void print(std::FILE* stream, std::format_string<Args...> fmt, Args&&... args) {
+  std::print(stream, fmt, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+  requires(sizeof...(Args) != 1 || (!is_kwargs<std::remove_cvref_t<Args>> && ...))
+void print(std::format_string<Args...> fmt, Args&&... args) {
+  std::print(fmt, std::forward<Args>(args)...);
+}
+
+template <typename T>
+  requires(is_kwargs<T>)
+void println(std::FILE* stream, erl::named_format_string<T> fmt, T const& kwargs) {
+  formatting::StreamLock lock{stream};
+  formatting::FileBuffer buffer{stream};
+  fmt.emit(buffer, kwargs);
+  buffer.push_back('\n');
+}
+
+template <typename T>
+  requires(is_kwargs<T>)
+void println(erl::named_format_string<T> fmt, T const& kwargs) {
+  erl::println(stdout, fmt, kwargs);
+}
+
+template <typename... Args>
+  requires(sizeof...(Args) != 1 || (!is_kwargs<std::remove_cvref_t<Args>> && ...))
+void println(std::FILE* stream, std::format_string<Args...> fmt, Args&&... args) {
+  std::println(stream, fmt, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+  requires(sizeof...(Args) != 1 || (!is_kwargs<std::remove_cvref_t<Args>> && ...))
+void println(std::format_string<Args...> fmt, Args&&... args) {
+  std::println(fmt, std::forward<Args>(args)...);
+}
+
+template <typename T>
+  requires(is_kwargs<T>)
+std::string format(erl::named_format_string<T> fmt, T const& kwargs) {
+  return fmt.format(kwargs);
+}
+
+// Formats into a buffer on the stack. Its size is the largest possible
+// output of `fmt` for the member types of T, so the output always fits and
+// nothing is allocated. Fields with a format spec and types without a known
+// bound (strings, ranges, user types) need an explicit `capacity`, output
+// beyond it is truncated.
+template <_kwargs_impl::fixed_string fmt, std::size_t capacity = 0, typename T>
+  requires(is_kwargs<T>)
+#if KWARGS_STATS == 1
+auto format_inline(T const& kwargs, std::source_location where = std::source_location::current()) {
+#else
+auto format_inline(T const& kwargs) {
+#endif
+  constexpr auto bound = formatting::max_output_size<fmt, T>();
+  static_assert(bound != 0 || capacity != 0,
+                std::string{"Output size of `"} + std::string_view{fmt} +
+                    "` is unbounded, specify a capacity: erl::format_inline<fmt, capacity>(kwargs)");
+  constexpr auto size = capacity != 0 ? capacity : bound;
+
+  constexpr auto emit = erl::named_format_string<T>::compile(std::string_view{fmt});
+
+  formatting::InlineString<size> result;
+  {
+#if KWARGS_STATS == 1
+    _kwargs_impl::stats_scope scope{stats::kind::format, std::string_view{fmt}, _kwargs_impl::stats_location(where)};
+#endif
+    formatting::InlineBuffer<size> buffer{result};
+    emit(buffer, kwargs);
+#if KWARGS_STATS == 1
+    scope.bytes = buffer.written();
+#endif
+  }
+  return result;
+}
+
+// Formats at compile time when evaluated as a constant expression, ie. when
+// initializing a constexpr variable or a static one from constant arguments,
+// and at runtime otherwise. Only fields without format spec of string,
+// integral, bool and char type are formatted at compile time.
+template <_kwargs_impl::fixed_string fmt, typename T>
+  requires(is_kwargs<T>)
+#if KWARGS_STATS == 1
+constexpr formatting::StaticFormatResult static_format(T const& kwargs,
+                                                       std::source_location where = std::source_location::current()) {
+#else
+constexpr formatting::StaticFormatResult static_format(T const& kwargs) {
+#endif
+  if consteval {
+    constexpr auto plan = formatting::constant_plan<fmt, T>();
+    if constexpr (plan != nullptr) {
+      std::string out;
+      {
+        formatting::StringBuffer buffer{out};
+        plan(buffer, kwargs);
+      }
+      return formatting::StaticFormatResult{std::string_view{std::define_static_string(out), out.size()}};
+    }
+  }
+  constexpr auto emit = erl::named_format_string<T>::compile(std::string_view{fmt});
+
+  std::string out;
+  {
+#if KWARGS_STATS == 1
+    _kwargs_impl::stats_scope scope{stats::kind::format, std::string_view{fmt}, _kwargs_impl::stats_location(where)};
+#endif
+    formatting::StringBuffer buffer{out};
+    emit(buffer, kwargs);
+#if KWARGS_STATS == 1
+    scope.bytes = buffer.written();
+#endif
+  }
+  return formatting::StaticFormatResult{std::move(out)};
+}
+
+template <typename... Args>
+  requires(sizeof...(Args) != 1 || (!is_kwargs<std::remove_cvref_t<Args>> && ...))
+std::string format(std::format_string<Args...> fmt, Args&&... args) {
+  return std::format(fmt, std::forward<Args>(args)...);
+}
+
+template <std::output_iterator<char const&> Out, typename T>
+  requires(is_kwargs<T>)
+Out format_to(Out out, erl::named_format_string<T> fmt, T const& kwargs) {
+  formatting::IteratorBuffer<Out> buffer{std::move(out)};
+  fmt.emit(buffer, kwargs);
+  return std::move(buffer).finish().out;
+}
+
+template <std::output_iterator<char const&> Out, typename... Args>
+  requires(sizeof...(Args) != 1 || (!is_kwargs<std::remove_cvref_t<Args>> && ...))
+Out format_to(Out out, std::format_string<Args...> fmt, Args&&... args) {
+  return std::format_to(std::move(out), fmt, std::forward<Args>(args)...);
+}
+
+template <std::output_iterator<char const&> Out, typename T>
+  requires(is_kwargs<T>)
+std::format_to_n_result<Out> format_to_n(Out out,
+                                         std::iter_difference_t<Out> n,
+                                         erl::named_format_string<T> fmt,
+                                         T const& kwargs) {
+  formatting::IteratorBuffer<Out> buffer{std::move(out), n};
+  fmt.emit(buffer, kwargs);
+  return std::move(buffer).finish();
+}
+
+template <std::output_iterator<char const&> Out, typename... Args>
+  requires(sizeof...(Args) != 1 || (!is_kwargs<std::remove_cvref_t<Args>> && ...))
+std::format_to_n_result<Out> format_to_n(Out out,
+                                         std::iter_difference_t<Out> n,
+                                         std::format_string<Args...> fmt,
+                                         Args&&... args) {
+  return std::format_to_n(std::move(out), n, fmt, std::forward<Args>(args)...);
+}
+
+template <typename T>
+  requires(is_kwargs<T>)
+std::size_t formatted_size(erl::named_format_string<T> fmt, T const& kwargs) {
+  formatting::CountingBuffer buffer;
+  fmt.emit(buffer, kwargs);
+  return buffer.count();
+}
+
+template <typename... Args>
+  requires(sizeof...(Args) != 1 || (!is_kwargs<std::remove_cvref_t<Args>> && ...))
+std::size_t formatted_size(std::format_string<Args...> fmt, Args&&... args) {
+  return std::formatted_size(fmt, std::forward<Args>(args)...);
+}
+
+struct format_range_options {
+  // written after every record
+  std::string_view terminator = "\n";
+  // 0 uses one thread per core, parallel formatting requires a sized random access range
+  unsigned threads = 1;
+  // fewer records than this per thread do not amortize handing a chunk to a worker
+  std::size_t min_records_per_thread = 8192;
+};
+
+namespace formatting {
+template <typename Args, typename It, typename S>
+void format_records(Buffer& buffer,
+                    typename NamedFormatString<Args>::emit_type emit,
+                    It first,
+                    S last,
+                    std::string_view terminator) {
+  for (; first != last; ++first) {
+    emit(buffer, *first);
+    buffer.append(terminator);
+  }
+}
+
+// Workers shared by all parallel format_range calls. They are started on the
+// first parallel call, one less than there are cores since the calling thread
+// takes part, and kept until exit. Every call queues one batch of chunks,
+// idle workers and the caller take chunks from it until none are left.
+class RangePool {
+  struct Batch {
+    void (*run)(void* context, std::size_t chunk);
+    void* context;
+    std::size_t chunks;
+    std::atomic<std::size_t> next{0};
+    // workers holding a pointer to the batch, guarded by `mutex`
+    std::size_t users = 0;
+  };
+
+  std::mutex mutex;
+  std::condition_variable_any wakeup;
+  std::condition_variable_any finished;
+  std::vector<Batch*> queue;
+  std::vector<std::jthread> workers;
+
+  static void work_on(Batch& batch) {
+    for (auto chunk = batch.next.fetch_add(1, std::memory_order_relaxed); chunk < batch.chunks;
+         chunk      = batch.next.fetch_add(1, std::memory_order_relaxed)) {
+      batch.run(batch.context, chunk);
+    }
+  }
+
+  void work(std::stop_token stop) {
+    std::unique_lock lock{mutex};
+    while (wakeup.wait(lock, stop, [&] { return !queue.empty(); })) {
+      auto* batch = queue.front();
+      if (batch->next.load(std::memory_order_relaxed) >= batch->chunks) {
+        queue.erase(queue.begin());
+        continue;
+      }
+      ++batch->users;
+      lock.unlock();
+      work_on(*batch);
+      lock.lock();
+      if (--batch->users == 0) {
+        finished.notify_all();
+      }
+    }
+  }
+
+public:
+  static RangePool& instance() {
+    static RangePool pool;
+    return pool;
+  }
+
+  // Calls `fnc(chunk)` for every chunk in [0, chunks) and returns once all
+  // calls returned. `fnc` must not throw.
+  template <typename F>
+  void run(std::size_t chunks, F& fnc) {
+    Batch batch{[](void* context, std::size_t chunk) { (*static_cast<F*>(context))(chunk); }, &fnc, chunks};
+    {
+      std::lock_guard lock{mutex};
+      if (workers.empty()) {
+        auto const count = std::max(2U, std::thread::hardware_concurrency()) - 1;
+        workers.reserve(count);
+        for (unsigned idx = 0; idx < count; ++idx) {
+          workers.emplace_back([this](std::stop_token stop) { work(std::move(stop)); });
+        }
+      }
+      queue.push_back(&batch);
+    }
+    wakeup.notify_all();
+
+    work_on(batch);
+
+    // every chunk is taken, wait for the workers still formatting theirs
+    std::unique_lock lock{mutex};
+    std::erase(queue, &batch);
+    finished.wait(lock, [&] { return batch.users == 0; });
+  }
+};
+}  // namespace formatting
+
+// Formats every record of `records` with `fmt`, appending to `out`. The
+// format string is compiled once and all records are written into the one
+// growing string. In parallel mode the range is split into contiguous
+// chunks that are formatted by the calling thread and the workers of a
+// shared pool, every chunk into a string of its own, and appended in order,
+// so the output is the same as sequentially. If formatting throws, `out` is
+// left as it was before the call.
+template <std::ranges::input_range R>
+  requires(is_kwargs<std::ranges::range_value_t<R>> &&
+           std::convertible_to<std::ranges::range_reference_t<R>, std::ranges::range_value_t<R> const&>)
+void format_range(erl::named_format_string<std::ranges::range_value_t<R>> fmt,
+                  R&& records,
+                  std::string& out,
+                  format_range_options options = {}) {
+  using Args = std::ranges::range_value_t<R>;
+
+  auto const original = out.size();
+  try {
+    if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>) {
+      auto const count   = static_cast<std::size_t>(std::ranges::size(records));
+      std::size_t threads = options.threads != 0 ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+      threads             = std::min(threads, count / std::max(options.min_records_per_thread, std::size_t{1}));
+
+      if (threads > 1) {
+        auto const first = std::ranges::begin(records);
+        auto chunk_begin = [&](std::size_t chunk) {
+          return first + static_cast<std::ranges::range_difference_t<R>>(count * chunk / threads);
+        };
+
+        // the first chunk is formatted straight into `out`
+        std::vector<std::string> chunks(threads - 1);
+        std::vector<std::exception_ptr> errors(threads);
+        auto format_chunk = [&](std::size_t chunk) {
+          try {
+            formatting::StringBuffer buffer{chunk == 0 ? out : chunks[chunk - 1]};
+            formatting::format_records<Args>(
+                buffer, fmt.emit, chunk_begin(chunk), chunk_begin(chunk + 1), options.terminator);
+          } catch (...) {
+            errors[chunk] = std::current_exception();
+          }
+        };
+        formatting::RangePool::instance().run(threads, format_chunk);
+
+        for (auto const& error : errors) {
+          if (error) {
+            std::rethrow_exception(error);
+          }
+        }
+        std::size_t total = out.size();
+        for (auto const& chunk : chunks) {
+          total += chunk.size();
+        }
+        out.reserve(total);
+        for (auto const& chunk : chunks) {
+          out += chunk;
+        }
+        return;
+      }
+    }
+
+    formatting::StringBuffer buffer{out};
+    formatting::format_records<Args>(
+        buffer, fmt.emit, std::ranges::begin(records), std::ranges::end(records), options.terminator);
+  } catch (...) {
+    // records formatted before the exception are dropped
+    out.resize(original);
+    throw;
+  }
+}
+
+#if KWARGS_SINKS == 1 || KWARGS_LOGGING == 1
+namespace _kwargs_impl {
+// Per-thread cache of the per-thread state of Sink and Logger instances,
+// direct mapped on the instance id so that a thread alternating between a few
+// instances does not take their registry mutex. Ids are never reused, an entry
+// of a destroyed instance cannot match a later one.
+template <typename T>
+class thread_cache {
+  struct entry {
+    std::uint64_t id = 0;
+    T* value         = nullptr;
+  };
+  static constexpr std::size_t size = 16;
+
+  static std::array<entry, size>& entries() {
+    thread_local std::array<entry, size> entries;
+    return entries;
+  }
+
+public:
+  static T* find(std::uint64_t id) {
+    auto const& slot = entries()[id % size];
+    return slot.id == id ? slot.value : nullptr;
+  }
+  static void store(std::uint64_t id, T* value) { entries()[id % size] = {id, value}; }
+};
+}  // namespace _kwargs_impl
+#endif
+
+#if KWARGS_SINKS == 1
+// Destination for erl::print/println. Every thread formats into its own
+// buffer, a call's output is never split, so lines of concurrent writers do
+// not interleave. Buffers are handed to the destination when they reach
+// `batch_size`, on flush() and every `max_delay` from a background thread,
+// which collects all pending buffers into a single write.
+class Sink {
+public:
+  struct options {
+    std::size_t batch_size = 8192;
+    // zero disables the background flush
+    std::chrono::milliseconds max_delay{20};
+  };
+
+  Sink(Sink const&)            = delete;
+  Sink& operator=(Sink const&) = delete;
+
+  // writes everything printed so far by any thread and syncs the destination
+  void flush() {
+    write_pending();
+    std::lock_guard lock{write_mutex};
+    sync_(*this);
+  }
+
+  template <typename Args>
+  void print(formatting::NamedFormatString<Args> fmt, Args const& kwargs, bool newline = false) {
+    auto& buffer = local_buffer();
+    std::unique_lock lock{buffer.mutex};
+    {
+      formatting::StringBuffer out{buffer.pending};
+      fmt.emit(out, kwargs);
+      if (newline) {
+        out.push_back('\n');
+      }
+    }
+    if (buffer.pending.size() >= batch_size) {
+      std::string chunk = std::exchange(buffer.pending, std::move(buffer.spare));
+      lock.unlock();
+      {
+        std::lock_guard write_lock{write_mutex};
+        std::string_view const view{chunk};
+        write_(*this, {&view, 1});
+      }
+      chunk.clear();
+      lock.lock();
+      buffer.spare = std::move(chunk);
+    }
+  }
+
+protected:
+  // writes all chunks in order
+  using write_type = void (*)(Sink&, std::span<std::string_view const>);
+  using sync_type  = void (*)(Sink&);
+
+  Sink(write_type write, sync_type sync, options opts)
+      : write_(write)
+      , sync_(sync)
+      , batch_size(opts.batch_size)
+      , max_delay(opts.max_delay) {
+    // the flusher only writes after something was printed, by then the derived sink is constructed
+    if (max_delay.count() > 0) {
+      flusher = std::jthread([this](std::stop_token stop) { run(stop); });
+    }
+  }
+  ~Sink() = default;
+
+  // Stops the background flush and writes what is left. Called by the
+  // destructor of every sink, the destination must still be alive.
+  void close() {
+    if (flusher.joinable()) {
+      flusher.request_stop();
+      flusher.join();
+    }
+    flush();
+  }
+
+private:
+  struct ThreadBuffer {
+    std::thread::id owner;
+    std::mutex mutex;
+    std::string pending;
+    std::string spare;
+  };
+
+  write_type write_;
+  sync_type sync_;
+  std::size_t batch_size;
+  std::chrono::milliseconds max_delay;
+  std::uint64_t const id = next_id();
+
+  // guards `buffers`
+  std::mutex registry_mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  // held while chunks are collected and written, this keeps the chunks of one thread in order
+  std::mutex write_mutex;
+  std::jthread flusher;
+
+  static std::uint64_t next_id() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+  }
+
+  ThreadBuffer& local_buffer() {
+    // sinks are identified by id, an address might be reused by a later sink
+    if (auto* cached = _kwargs_impl::thread_cache<ThreadBuffer>::find(id)) {
+      return *cached;
+    }
+
+    std::lock_guard lock{registry_mutex};
+    auto thread = std::this_thread::get_id();
+    auto it     = std::ranges::find(buffers, thread, [](auto const& buffer) { return buffer->owner; });
+    if (it == buffers.end()) {
+      buffers.push_back(std::make_unique<ThreadBuffer>(thread));
+      it = std::prev(buffers.end());
+    }
+    _kwargs_impl::thread_cache<ThreadBuffer>::store(id, it->get());
+    return **it;
+  }
+
+  void write_pending() {
+    std::vector<ThreadBuffer*> snapshot;
+    {
+      std::lock_guard lock{registry_mutex};
+      for (auto const& buffer : buffers) {
+        snapshot.push_back(buffer.get());
+      }
+    }
+
+    std::lock_guard write_lock{write_mutex};
+    std::vector<std::string> chunks;
+    for (auto* buffer : snapshot) {
+      std::lock_guard lock{buffer->mutex};
+      if (!buffer->pending.empty()) {
+        chunks.push_back(std::exchange(buffer->pending, std::move(buffer->spare)));
+      }
+    }
+    if (chunks.empty()) {
+      return;
+    }
+    std::vector<std::string_view> views(chunks.begin(), chunks.end());
+    write_(*this, views);
+  }
+
+  void run(std::stop_token stop) {
+    std::mutex mutex;
+    std::condition_variable_any wakeup;
+    std::unique_lock lock{mutex};
+    while (!stop.stop_requested()) {
+      wakeup.wait_for(lock, stop, max_delay, [] { return false; });
+      write_pending();
+    }
+  }
+};
+
+// FILE* destination, all chunks of a batch are written under one stream lock
+class FileSink : public Sink {
+  std::FILE* stream;
+
+  static void write(Sink& self, std::span<std::string_view const> chunks) {
+    auto* stream = static_cast<FileSink&>(self).stream;
+    ::flockfile(stream);
+    for (auto chunk : chunks) {
+      std::fwrite(chunk.data(), 1, chunk.size(), stream);
+    }
+    ::funlockfile(stream);
+  }
+  static void sync(Sink& self) { std::fflush(static_cast<FileSink&>(self).stream); }
+
+public:
+  explicit FileSink(std::FILE* stream, options opts = {})
+      : Sink(&write, &sync, opts)
+      , stream(stream) {}
+  ~FileSink() { close(); }
+};
+
+#  if __has_include(<sys/uio.h>)
+// raw file descriptor, batches are written with writev
+class FdSink : public Sink {
+  int fd;
+
+  static void write(Sink& self, std::span<std::string_view const> chunks) {
+    auto const fd = static_cast<FdSink&>(self).fd;
+    std::vector<::iovec> pending;
+    for (auto chunk : chunks) {
+      if (!chunk.empty()) {
+        pending.push_back({const_cast<char*>(chunk.data()), chunk.size()});
+      }
+    }
+
+    auto* current = pending.data();
+    auto* end     = current + pending.size();
+    while (current != end) {
+      auto count   = static_cast<int>(std::min<std::ptrdiff_t>(end - current, IOV_MAX));
+      auto written = ::writev(fd, current, count);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        // nothing sensible to do about a broken destination, drop the batch like stdio would
+        return;
+      }
+      // skip fully written chunks and advance into a partially written one
+      auto remaining = static_cast<std::size_t>(written);
+      while (current != end && remaining >= current->iov_len) {
+        remaining -= current->iov_len;
+        ++current;
+      }
+      if (current != end) {
+        current->iov_base = static_cast<char*>(current->iov_base) + remaining;
+        current->iov_len -= remaining;
+      }
+    }
+  }
+  static void sync(Sink&) {}
+
+public:
+  explicit FdSink(int fd, options opts = {})
+      : Sink(&write, &sync, opts)
+      , fd(fd) {}
+  ~FdSink() { close(); }
+};
+#  endif
+
+// collects output in memory, mainly for tests
+class MemorySink : public Sink {
+  mutable std::mutex mutex;
+  std::string contents;
+
+  static void write(Sink& self, std::span<std::string_view const> chunks) {
+    auto& sink = static_cast<MemorySink&>(self);
+    std::lock_guard lock{sink.mutex};
+    for (auto chunk : chunks) {
+      sink.contents += chunk;
+    }
+  }
+  static void sync(Sink&) {}
+
+public:
+  explicit MemorySink(options opts = {}) : Sink(&write, &sync, opts) {}
+  ~MemorySink() { close(); }
+
+  // output written so far, call flush() first to include buffered output
+  [[nodiscard]] std::string str() const {
+    std::lock_guard lock{mutex};
+    return contents;
+  }
+};
+
+class StreamSink : public Sink {
+  std::ostream& stream;
+
+  static void write(Sink& self, std::span<std::string_view const> chunks) {
+    auto& stream = static_cast<StreamSink&>(self).stream;
+    for (auto chunk : chunks) {
+      stream.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    }
+  }
+  static void sync(Sink& self) { static_cast<StreamSink&>(self).stream.flush(); }
+
+public:
+  explicit StreamSink(std::ostream& stream, options opts = {})
+      : Sink(&write, &sync, opts)
+      , stream(stream) {}
+  ~StreamSink() { close(); }
+};
+
+template <typename T>
+  requires(is_kwargs<T>)
+void print(Sink& sink, erl::named_format_string<T> fmt, T const& kwargs) {
+  sink.print(fmt, kwargs);
+}
+
+template <typename T>
+  requires(is_kwargs<T>)
+void println(Sink& sink, erl::named_format_string<T> fmt, T const& kwargs) {
+  sink.print(fmt, kwargs, true);
+}
+#endif
+
+#if KWARGS_LOGGING == 1
+namespace _kwargs_impl {
+// Strings are serialized by value: their characters are copied into the log
+// record and the deferred pack refers to them through a string_view.
+template <typename T>
+using deferred_member_t =
+    std::conditional_t<formatting::is_fast_string<std::decay_t<T>>, std::string_view, std::decay_t<T>>;
+
+// Owning copy of a pack as stored in a log record. References are dropped and
+// string-like members are replaced by views into the record.
+template <typename T>
+struct deferred_kwargs {
+  struct type;
+  consteval {
+    std::vector<std::meta::info> types;
+    std::vector<std::string_view> names;
+    for (auto member : members<T>) {
+      types.push_back(dealias(substitute(^^deferred_member_t, {type_of(member)})));
+      names.push_back(identifier_of(member));
+    }
+    define_aggregate(^^type, pack_members(types, names));
+  }
+};
+
+template <typename T>
+std::size_t deferred_string_size(T const& value) {
+  if constexpr (std::same_as<std::decay_t<T>, char const*> || std::same_as<std::decay_t<T>, char*>) {
+    return value == nullptr ? 0 : std::char_traits<char>::length(value);
+  } else if constexpr (formatting::is_fast_string<std::decay_t<T>>) {
+    return value.size();
+  } else {
+    return 0;
+  }
+}
+
+// copies string-like values into the record tail, at most `budget` characters
+// are copied in total so that every record fits into its ring
+template <typename T>
+deferred_member_t<T> defer_member(T const& value, char*& tail, std::size_t& budget) {
+  if constexpr (formatting::is_fast_string<std::decay_t<T>>) {
+    auto size = std::min(deferred_string_size(value), budget);
+    if (size != 0) {
+      std::char_traits<char>::copy(tail, std::string_view{value}.data(), size);
+    }
+    std::string_view copy{tail, size};
+    tail += size;
+    budget -= size;
+    return copy;
+  } else {
+    return value;
+  }
+}
+
+struct LogRecord {
+  // size including this header, multiple of `unit`
+  std::size_t size;
+  // formats and destroys the payload, nullptr for padding at the end of the ring
+  void (*process)(formatting::Buffer&, LogRecord&);
+  // the NamedFormatString emit function of the payload, type erased
+  void (*emit)();
+  // string arguments were cut to fit into the ring
+  bool truncated = false;
+
+  // the payload starts one unit after the header
+  static constexpr std::size_t unit = 32;
+  static_assert(sizeof(LogRecord) <= unit);
+
+  [[nodiscard]] std::byte* payload() { return reinterpret_cast<std::byte*>(this) + unit; }
+};
+
+template <typename Args>
+void process_record(formatting::Buffer& buffer, LogRecord& record) {
+  auto* kwargs = std::launder(reinterpret_cast<Args*>(record.payload()));
+  auto emit    = reinterpret_cast<typename formatting::NamedFormatString<Args>::emit_type>(record.emit);
+  emit(buffer, *kwargs);
+  if (record.truncated) {
+    buffer.append(" [truncated]");
+  }
+  buffer.push_back('\n');
+  std::destroy_at(kwargs);
+}
+
+// Single producer, single consumer byte ring. Records are contiguous, if one
+// does not fit before the end of the storage the remainder is skipped using a
+// padding record. Positions grow monotonically and are masked on access.
+class LogRing {
+public:
+  LogRing(std::thread::id owner, std::size_t capacity)
+      : owner(owner)
+      , capacity_(std::bit_ceil(std::max(capacity, 4 * LogRecord::unit)))
+      , storage(static_cast<std::byte*>(::operator new(capacity_, std::align_val_t{LogRecord::unit}))) {}
+
+  [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+  // producer side, `size` must be a multiple of LogRecord::unit and must not
+  // exceed the capacity. Waits until the consumer made enough room.
+  std::byte* reserve(std::size_t size) {
+    auto position = head.load(std::memory_order_relaxed);
+    auto offset   = position & (capacity_ - 1);
+
+    if (auto padding = capacity_ - offset; padding < size) {
+      // padding and record together may exceed the capacity, publish the
+      // padding on its own so the consumer can move past the wrap point
+      wait_for_room(position + padding);
+      ::new (storage.get() + offset) LogRecord{padding, nullptr, nullptr};
+      position += padding;
+      head.store(position, std::memory_order_release);
+      offset = 0;
+    }
+
+    wait_for_room(position + size);
+    pending = position + size;
+    return storage.get() + offset;
+  }
+
+  // producer side, publishes the record returned by the last reserve
+  void commit() { head.store(pending, std::memory_order_release); }
+
+  // consumer side, returns whether any record was processed
+  bool drain(formatting::Buffer& out) {
+    auto position = tail.load(std::memory_order_relaxed);
+    auto end      = head.load(std::memory_order_acquire);
+    if (position == end) {
+      return false;
+    }
+
+    while (position != end) {
+      auto* record = std::launder(reinterpret_cast<LogRecord*>(storage.get() + (position & (capacity_ - 1))));
+      if (record->process != nullptr) {
+        record->process(out, *record);
+      }
+      position += record->size;
+    }
+    tail.store(position, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] std::size_t published() const { return head.load(std::memory_order_acquire); }
+  [[nodiscard]] std::size_t consumed() const { return tail.load(std::memory_order_acquire); }
+
+  std::thread::id const owner;
+
+private:
+  struct Deallocate {
+    void operator()(std::byte* memory) const { ::operator delete(memory, std::align_val_t{LogRecord::unit}); }
+  };
+
+  void wait_for_room(std::size_t end) const {
+    while (end - tail.load(std::memory_order_acquire) > capacity_) {
+      std::this_thread::yield();
+    }
+  }
+
+  std::size_t capacity_;
+  std::unique_ptr<std::byte[], Deallocate> storage;
+  std::size_t pending = 0;
+
+  alignas(64) std::atomic<std::size_t> head{0};
+  alignas(64) std::atomic<std::size_t> tail{0};
+};
+}  // namespace _kwargs_impl
+
+template <typename T>
+using deferred_kwargs_t = kwargs_t<typename _kwargs_impl::deferred_kwargs<typename T::type>::type>;
+
+// Deferred-formatting logger. The calling thread only copies the pack into a
+// per-thread ring together with the compiled format plan, formatting and I/O
+// happen on a background thread. Records of one thread are written in order,
+// there is no ordering across threads. String arguments that do not fit into
+// the ring are cut, such records end in " [truncated]".
+class Logger {
+public:
+  explicit Logger(std::FILE* stream = stdout, std::size_t ring_capacity = std::size_t{1} << 16)
+      : stream(stream)
+      , ring_capacity(ring_capacity)
+      , worker([this](std::stop_token stop) { run(stop); }) {}
+
+  Logger(Logger const&)            = delete;
+  Logger& operator=(Logger const&) = delete;
+
+  // all records logged so far are written before the worker stops
+  ~Logger() {
+    worker.request_stop();
+    worker.join();
+  }
+
+  template <typename T>
+    requires(is_kwargs<T>)
+  void log(formatting::NamedFormatString<deferred_kwargs_t<std::type_identity_t<T>>> fmt, T const& kwargs) {
+    using Args = deferred_kwargs_t<T>;
+    static_assert(alignof(Args) <= _kwargs_impl::LogRecord::unit, "Over-aligned keyword arguments cannot be logged");
+
+    auto& ring        = local_ring();
+    auto const fixed  = 2 * _kwargs_impl::LogRecord::unit + sizeof(Args);
+    if (fixed > ring.capacity()) {
+      throw std::length_error("Keyword arguments do not fit into the log ring.");
+    }
+    auto budget       = ring.capacity() - fixed;
+    auto string_bytes = [:_kwargs_impl::sequence(_kwargs_impl::member_count<typename T::type>):] >>
+                        [&]<std::size_t... Idx> {
+                          return (std::size_t{0} + ... + _kwargs_impl::deferred_string_size(get<Idx>(kwargs)));
+                        };
+    auto const truncated = string_bytes > budget;
+    budget               = std::min(budget, string_bytes);
+
+    auto const unit = _kwargs_impl::LogRecord::unit;
+    auto size       = (unit + sizeof(Args) + budget + unit - 1) / unit * unit;
+    auto* memory    = ring.reserve(size);
+    auto* record    = ::new (memory) _kwargs_impl::LogRecord{size,
+                                                          &_kwargs_impl::process_record<Args>,
+                                                          reinterpret_cast<void (*)()>(fmt.emit),
+                                                          truncated};
+    auto* tail = reinterpret_cast<char*>(record->payload() + sizeof(Args));
+
+    // braced initialization evaluates in order, strings are laid out member by member
+    [:_kwargs_impl::expand(_kwargs_impl::declaration_order<typename Args::type>()):] >> [&]<std::size_t... Idx> {
+      ::new (record->payload()) Args{{_kwargs_impl::defer_member(get<Idx>(kwargs), tail, budget)...}};
+    };
+    ring.commit();
+  }
+
+  // blocks until everything logged before this call has been written to the stream
+  void flush() {
+    std::vector<std::pair<_kwargs_impl::LogRing*, std::size_t>> targets;
+    {
+      std::lock_guard lock{mutex};
+      for (auto const& ring : rings) {
+        targets.emplace_back(ring.get(), ring->published());
+      }
+    }
+    for (auto [ring, position] : targets) {
+      while (ring->consumed() < position) {
+        std::this_thread::yield();
+      }
+    }
+    // the worker flushes its buffer at the end of every pass
+    auto pass = passes.load(std::memory_order_acquire);
+    while (passes.load(std::memory_order_acquire) < pass + 2) {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  std::FILE* stream;
+  std::size_t ring_capacity;
+  std::uint64_t const id = next_id();
+
+  std::mutex mutex;
+  std::vector<std::unique_ptr<_kwargs_impl::LogRing>> rings;
+  std::atomic<std::uint64_t> passes{0};
+  std::jthread worker;
+
+  static std::uint64_t next_id() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+  }
+
+  _kwargs_impl::LogRing& local_ring() {
+    // loggers are identified by id, an address might be reused by a later logger
+    if (auto* cached = _kwargs_impl::thread_cache<_kwargs_impl::LogRing>::find(id)) {
+      return *cached;
+    }
+
+    std::lock_guard lock{mutex};
+    auto thread = std::this_thread::get_id();
+    auto it     = std::ranges::find(rings, thread, &_kwargs_impl::LogRing::owner);
+    if (it == rings.end()) {
+      rings.push_back(std::make_unique<_kwargs_impl::LogRing>(thread, ring_capacity));
+      it = std::prev(rings.end());
+    }
+    _kwargs_impl::thread_cache<_kwargs_impl::LogRing>::store(id, it->get());
+    return **it;
+  }
+
+  void run(std::stop_token stop) {
+    formatting::FileBuffer out{stream};
+    std::vector<_kwargs_impl::LogRing*> snapshot;
+    while (true) {
+      {
+        std::lock_guard lock{mutex};
+        snapshot.clear();
+        for (auto const& ring : rings) {
+          snapshot.push_back(ring.get());
+        }
+      }
+
+      bool busy = false;
+      for (auto* ring : snapshot) {
+        busy |= ring->drain(out);
+      }
+      out.flush();
+      std::fflush(stream);
+      passes.fetch_add(1, std::memory_order_release);
+
+      if (!busy) {
+        if (stop.stop_requested()) {
+          break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+  }
+};
+
+inline Logger& default_logger() {
+  static Logger logger{stdout};
+  return logger;
+}
+
+template <typename T>
+  requires(is_kwargs<T>)
+void log(formatting::NamedFormatString<deferred_kwargs_t<std::type_identity_t<T>>> fmt, T const& kwargs) {
+  default_logger().log(fmt, kwargs);
+}
+#endif
+
+}  // namespace erl
+
+template <typename T>
+struct std::formatter<erl::formatting::Preparsed<T>, char> {
+  constexpr auto parse(std::format_parse_context& context) { return context.begin(); }
+
+  template <typename Context>
+  auto format(erl::formatting::Preparsed<T> const& field, Context& context) const {
+    return field.formatter.format(field.value, context);
+  }
+};
@@ -0,0 +1,193 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// kwargs::invoke and kwargs::bind, calling functions with keyword arguments.
+// Requires parameter reflection. Included by kwargs.h.
+
+#include "config.h"
+#include "core.h"
+#include "stats.h"
+
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if KWARGS_STATS == 1
+#  include <bit>
+#  include <cstdint>
+#  include <source_location>
+#endif
+
+KWARGS_EXPORT namespace erl {
+
+#if __has_feature(parameter_reflection)
+namespace kwargs {
+template <std::meta::info F>
+  requires(is_function(F))
+struct Wrap {
+#if KWARGS_STATS == 1
+  static constexpr std::string_view stats_name = std::define_static_string(identifier_of(F));
+#endif
+
+  template <typename T, std::size_t PosOnly = 0>
+  static constexpr void check_args() {
+    [:_kwargs_impl::expand(parameters_of(F) | std::views::take(PosOnly)):] >>= [&]<auto Param> {
+      static_assert(!_kwargs_impl::has_member<T>(identifier_of(Param)),
+                    "In call to `" + std::string(identifier_of(F)) + "`: Positional argument `" + identifier_of(Param) +
+                        "` repeated as keyword argument.");
+    };
+
+    [:_kwargs_impl::expand(parameters_of(F) | std::views::drop(PosOnly)):] >>= [&]<auto Param> {
+      static_assert(
+          _kwargs_impl::has_member<T>(identifier_of(Param)),
+          "In call to `" + std::string(identifier_of(F)) + "`: Argument `" + identifier_of(Param) + "` missing.");
+    };
+  }
+
+  // With KWARGS_STATS the call operators are never inlined: a variadic call
+  // cannot take a defaulted source_location, so calls are keyed on their
+  // return address instead.
+#if KWARGS_STATS == 1
+  [[gnu::noinline]]
+#endif
+  static constexpr decltype(auto) operator()()
+    requires requires { [:F:](); }
+  {
+#if KWARGS_STATS == 1
+    stats::location where{};
+    if !consteval {
+      where.address = std::bit_cast<std::uintptr_t>(__builtin_return_address(0));
+    }
+    _kwargs_impl::stats_scope scope{stats::kind::invoke, stats_name, where};
+#endif
+    return [:F:]();
+  }
+
+  template <typename... Args>
+    requires(sizeof...(Args) > 0)
+#if KWARGS_STATS == 1
+  [[gnu::noinline]]
+#endif
+  static constexpr decltype(auto) operator()(Args&&... args) {
+    static constexpr std::size_t args_size = sizeof...(Args) - 1;
+    using T                                = std::remove_cvref_t<Args...[args_size]>;
+#if KWARGS_STATS == 1
+    stats::location where{};
+    if !consteval {
+      where.address = std::bit_cast<std::uintptr_t>(__builtin_return_address(0));
+    }
+    _kwargs_impl::stats_scope scope{stats::kind::invoke, stats_name, where};
+#endif
+
+    if constexpr (erl::is_kwargs<T>) {
+      check_args<typename T::type, args_size>();
+
+      return [:_kwargs_impl::expand(parameters_of(F) | std::views::drop(args_size)):] >> [&]<auto... Params> {
+        return [:_kwargs_impl::sequence(args_size):] >> [&]<std::size_t... Idx> {
+          return [:F:](
+              /* positional arguments */
+              std::forward<Args...[Idx]>(args...[Idx])...,
+              /* keyword arguments */
+              get<_kwargs_impl::get_member_index<typename T::type>(identifier_of(Params))>(
+                  std::forward<Args...[args_size]>(args...[args_size]))...);
+        };
+      };
+    } else {
+      // no keyword arguments
+      return [:F:](std::forward<Args>(args)...);
+    }
+  }
+};
+
+template <auto F>
+constexpr inline Wrap<F> invoke{};
+
+// Partial application with keyword arguments. The bound pack is stored inline,
+// the parameter to member mapping only depends on the number of positional
+// arguments and is resolved at compile time, so every call is a direct call to F.
+template <std::meta::info F, typename T>
+  requires(is_function(F) && is_kwargs<T>)
+class Bound {
+  T kwargs;
+#if KWARGS_STATS == 1
+  // calls are counted at the site that bound the arguments
+  stats::location bound_at;
+#endif
+
+  template <std::size_t PosOnly>
+  static consteval std::vector<std::size_t> member_indices() {
+    std::vector<std::size_t> indices;
+    for (auto param : parameters_of(F) | std::views::drop(PosOnly)) {
+      indices.push_back(_kwargs_impl::get_member_index<typename T::type>(identifier_of(param)));
+    }
+    return indices;
+  }
+
+public:
+#if KWARGS_STATS == 1
+  template <typename U>
+    requires std::same_as<std::remove_cvref_t<U>, T>
+  constexpr explicit Bound(U&& kwargs, std::source_location where = std::source_location::current())
+      : kwargs(std::forward<U>(kwargs))
+      , bound_at(_kwargs_impl::stats_location(where)) {}
+#else
+  template <typename U>
+    requires std::same_as<std::remove_cvref_t<U>, T>
+  constexpr explicit Bound(U&& kwargs) : kwargs(std::forward<U>(kwargs)) {}
+#endif
+
+  template <typename Self, typename... Args>
+  constexpr decltype(auto) operator()(this Self&& self, Args&&... args) {
+    Wrap<F>::template check_args<typename T::type, sizeof...(Args)>();
+#if KWARGS_STATS == 1
+    _kwargs_impl::stats_scope scope{stats::kind::invoke, Wrap<F>::stats_name, self.bound_at};
+#endif
+
+    return [:_kwargs_impl::expand(member_indices<sizeof...(Args)>()):] >> [&]<std::size_t... Members> {
+      return [:F:](std::forward<Args>(args)..., get<Members>(std::forward_like<Self>(self.kwargs))...);
+    };
+  }
+};
+
+template <std::meta::info F, typename T>
+  requires(is_function(F) && is_kwargs<std::remove_cvref_t<T>>)
+#if KWARGS_STATS == 1
+constexpr auto bind(T&& kwargs, std::source_location where = std::source_location::current()) {
+  return Bound<F, std::remove_cvref_t<T>>{std::forward<T>(kwargs), where};
+}
+#else
+constexpr auto bind(T&& kwargs) {
+  return Bound<F, std::remove_cvref_t<T>>{std::forward<T>(kwargs)};
+}
+#endif
+}  // namespace kwargs
+#endif
+
+}  // namespace erl
@@ -0,0 +1,218 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Lookup of members by a name only known at runtime: visit_arg, find_arg and
+// the perfect hash behind them. Included by kwargs.h.
+
+#include "config.h"
+#include "core.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+KWARGS_EXPORT namespace erl {
+
+namespace _kwargs_impl {
+// murmur3 finalizer
+constexpr std::uint64_t mix_hash(std::uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51'afd7'ed55'8ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ce'b9fe'1a85'ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+constexpr std::size_t hash_bucket(std::uint64_t hash, int bits) {
+  if (bits == 0) {
+    return 0;
+  }
+  return static_cast<std::size_t>((hash * 0x9e37'79b9'7f4a'7c15ULL) >> (64 - bits));
+}
+
+constexpr std::size_t hash_slot(std::uint64_t hash, std::uint8_t displacement, int bits) {
+  if (bits == 0) {
+    return 0;
+  }
+  return static_cast<std::size_t>(mix_hash(hash + displacement * 0x9e37'79b9'7f4a'7c15ULL) >> (64 - bits));
+}
+
+// Hash and displace. Names are grouped into about one bucket per name, then
+// starting with the largest bucket every bucket searches a displacement that
+// moves all of its names into free slots. Fails if a bucket cannot be placed.
+constexpr bool displace(std::span<std::uint64_t const> hashes,
+                        int bits,
+                        std::span<std::uint8_t> displacements,
+                        std::span<std::uint16_t> slots) {
+  auto const bucket_bits = std::max(bits - 1, 0);
+  std::vector<std::vector<std::uint16_t>> buckets(std::size_t{1} << bucket_bits);
+  for (std::size_t idx = 0; idx < hashes.size(); ++idx) {
+    buckets[hash_bucket(hashes[idx], bucket_bits)].push_back(static_cast<std::uint16_t>(idx));
+  }
+  std::vector<std::size_t> order(buckets.size());
+  for (std::size_t idx = 0; idx < order.size(); ++idx) {
+    order[idx] = idx;
+  }
+  std::ranges::sort(order, [&](std::size_t lhs, std::size_t rhs) {
+    return buckets[lhs].size() != buckets[rhs].size() ? buckets[lhs].size() > buckets[rhs].size() : lhs < rhs;
+  });
+
+  for (auto bucket : order) {
+    bool placed = buckets[bucket].empty();
+    for (unsigned displacement = 0; displacement <= 0xff && !placed; ++displacement) {
+      std::size_t filled = 0;
+      for (auto idx : buckets[bucket]) {
+        auto& slot = slots[hash_slot(hashes[idx], static_cast<std::uint8_t>(displacement), bits)];
+        if (slot != 0) {
+          break;
+        }
+        slot = static_cast<std::uint16_t>(idx + 1);
+        ++filled;
+      }
+      placed = filled == buckets[bucket].size();
+      if (placed) {
+        displacements[bucket] = static_cast<std::uint8_t>(displacement);
+      } else {
+        for (auto idx : buckets[bucket] | std::views::take(filled)) {
+          slots[hash_slot(hashes[idx], static_cast<std::uint8_t>(displacement), bits)] = 0;
+        }
+      }
+    }
+    if (!placed) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Collision free table over the member names of T, built at compile time by
+// hash and displace. Every name is hashed once, if no table is found after
+// growing it twice lookup falls back to comparing names. A lookup costs one
+// hash, two table reads and one string comparison.
+template <typename T>
+struct perfect_hash {
+  static_assert(member_count<T> < 0xffff, "Too many members for a perfect hash table");
+
+  static constexpr auto hashes = [] consteval {
+    std::array<std::uint64_t, member_count<T>> result{};
+    for (std::size_t idx = 0; idx < member_count<T>; ++idx) {
+      result[idx] = hash_name(member_names<T>[idx].name());
+    }
+    return result;
+  }();
+
+  static constexpr std::size_t bucket_count(int bits) { return std::size_t{1} << std::max(bits - 1, 0); }
+
+  // table size as a power of two, -1 if lookup compares names
+  static constexpr int bits = [] consteval {
+    int const base = std::bit_width(std::bit_ceil(2 * member_count<T>)) - 1;
+    for (int bits = base; bits <= base + 2; ++bits) {
+      std::vector<std::uint8_t> displacements(bucket_count(bits));
+      std::vector<std::uint16_t> slots(std::size_t{1} << bits);
+      if (displace(hashes, bits, displacements, slots)) {
+        return bits;
+      }
+    }
+    return -1;
+  }();
+
+  static constexpr int bucket_bits = std::max(bits - 1, 0);
+
+  struct table_type {
+    std::array<std::uint8_t, bits < 0 ? 0 : bucket_count(bits)> displacements;
+    // member index + 1, 0 for empty slots
+    std::array<std::uint16_t, bits < 0 ? 0 : std::size_t{1} << bits> slots;
+  };
+
+  static constexpr table_type table = [] consteval {
+    table_type result{};
+    if (bits >= 0) {
+      displace(hashes, bits, result.displacements, result.slots);
+    }
+    return result;
+  }();
+
+  // member index or -1UZ
+  static constexpr std::size_t find(std::string_view name) {
+    if constexpr (bits < 0) {
+      for (std::size_t idx = 0; idx < member_count<T>; ++idx) {
+        if (member_names<T>[idx].name() == name) {
+          return idx;
+        }
+      }
+      return -1UZ;
+    } else {
+      auto const hash = hash_name(name);
+      auto slot = table.slots[hash_slot(hash, table.displacements[hash_bucket(hash, bucket_bits)], bits)];
+      if (slot == 0 || member_names<T>[slot - 1].name() != name) {
+        return -1UZ;
+      }
+      return slot - 1UZ;
+    }
+  }
+};
+}  // namespace _kwargs_impl
+
+// runtime lookup
+// visit_arg invokes `visitor` with the member called `name`, forwarding the
+// value category of `kwargs` like get does. Returns false if there is no such
+// member. find_arg additionally checks the member type.
+template <typename T, typename F>
+  requires is_kwargs<std::remove_cvref_t<T>>
+constexpr bool visit_arg(T&& kwargs, std::string_view name, F&& visitor) {
+  using kwarg_tuple = typename std::remove_cvref_t<T>::type;
+  auto const index  = _kwargs_impl::perfect_hash<kwarg_tuple>::find(name);
+  if (index == -1UZ) {
+    return false;
+  }
+  // the fold compiles to a jump table on the member index
+  return [:_kwargs_impl::sequence(_kwargs_impl::member_count<kwarg_tuple>):] >> [&]<auto... Idx> {
+    return ((index == Idx && (visitor(get<Idx>(std::forward<T>(kwargs))), true)) || ...);
+  };
+}
+
+template <typename R, typename T>
+  requires is_kwargs<std::remove_const_t<T>>
+constexpr R* find_arg(T& kwargs, std::string_view name) noexcept {
+  R* result = nullptr;
+  visit_arg(kwargs, name, [&]<typename V>(V& value) {
+    if constexpr (std::same_as<std::remove_cv_t<V>, std::remove_cv_t<R>> && std::is_convertible_v<V*, R*>) {
+      result = std::addressof(value);
+    }
+  });
+  return result;
+}
+
+}  // namespace erl
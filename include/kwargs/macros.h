@@ -0,0 +1,63 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// make_args and make_args_ref. Modules do not export macros, users of the
+// erl.kwargs module include this header after importing it.
+
+#include <cstddef>
+#include <meta>
+#include <utility>
+
+#include "config.h"
+
+#define KWARGS_IMPL_MAKE(names, ...)                                                                          \
+  [__VA_ARGS__]<typename T>(this T _impl_this) {                                                              \
+    constexpr static auto _impl_captures =                                                                    \
+        define_static_array(nonstatic_data_members_of(^^T, std::meta::access_context::current()));            \
+    return [:erl::_kwargs_impl::sequence(_impl_captures.size()):] >> [&]<std::size_t... Idx> {                \
+      return erl::kwargs::make<names, (KWARGS_CANONICAL != 0)>(                                               \
+          std::forward<decltype(_impl_this.[:_impl_captures[Idx]:])>(_impl_this.[:_impl_captures[Idx]:])...); \
+    };                                                                                                        \
+  }()
+
+// prefixes every capture with `&`, turning `x, y = expr` into `&x, &y = expr`
+#define KWARGS_IMPL_PARENS ()
+#define KWARGS_IMPL_EXPAND(...)  KWARGS_IMPL_EXPAND3(KWARGS_IMPL_EXPAND3(KWARGS_IMPL_EXPAND3(KWARGS_IMPL_EXPAND3(__VA_ARGS__))))
+#define KWARGS_IMPL_EXPAND3(...) KWARGS_IMPL_EXPAND2(KWARGS_IMPL_EXPAND2(KWARGS_IMPL_EXPAND2(KWARGS_IMPL_EXPAND2(__VA_ARGS__))))
+#define KWARGS_IMPL_EXPAND2(...) KWARGS_IMPL_EXPAND1(KWARGS_IMPL_EXPAND1(KWARGS_IMPL_EXPAND1(KWARGS_IMPL_EXPAND1(__VA_ARGS__))))
+#define KWARGS_IMPL_EXPAND1(...) __VA_ARGS__
+#define KWARGS_IMPL_BORROW(...)  __VA_OPT__(KWARGS_IMPL_EXPAND(KWARGS_IMPL_BORROW_HELPER(__VA_ARGS__)))
+#define KWARGS_IMPL_BORROW_HELPER(capture, ...) \
+  &capture __VA_OPT__(, KWARGS_IMPL_BORROW_AGAIN KWARGS_IMPL_PARENS(__VA_ARGS__))
+#define KWARGS_IMPL_BORROW_AGAIN() KWARGS_IMPL_BORROW_HELPER
+
+#define make_args(...) KWARGS_IMPL_MAKE(#__VA_ARGS__, __VA_ARGS__)
+
+// Borrowing variant of make_args. Every argument is captured by reference and
+// the resulting pack holds references, so building it never copies.
+// Since nothing owns them, arguments must be lvalues. Because the preprocessor
+// splits the argument list, initializers containing top-level commas in
+// braces must be parenthesized.
+#define make_args_ref(...) KWARGS_IMPL_MAKE(#__VA_ARGS__, KWARGS_IMPL_BORROW(__VA_ARGS__))
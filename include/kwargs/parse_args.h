@@ -0,0 +1,260 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// erl::parse_args, command line and environment parsing into a pack.
+// Included by kwargs.h.
+
+#include "config.h"
+#include "core.h"
+#include "lookup.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+KWARGS_EXPORT namespace erl {
+
+namespace _kwargs_impl {
+template <typename T>
+constexpr inline bool is_optional_option = false;
+template <typename T>
+constexpr inline bool is_optional_option<std::optional<T>> = true;
+
+// `text` is null-terminated, it points into argv or the environment
+template <typename T>
+bool parse_option(std::string_view text, T& out) {
+  if constexpr (std::same_as<T, bool>) {
+    if (text == "true" || text == "1" || text == "yes" || text == "on") {
+      out = true;
+    } else if (text == "false" || text == "0" || text == "no" || text == "off") {
+      out = false;
+    } else {
+      return false;
+    }
+    return true;
+  } else if constexpr (std::is_enum_v<T>) {
+    bool found = false;
+    [:expand(enumerators_of(^^T)):] >>= [&]<auto Enumerator> {
+      if (!found && text == identifier_of(Enumerator)) {
+        out   = [:Enumerator:];
+        found = true;
+      }
+    };
+    return found;
+  } else if constexpr (std::integral<T> || std::floating_point<T>) {
+    auto const* end = text.data() + text.size();
+    auto result     = std::from_chars(text.data(), end, out);
+    return result.ec == std::errc{} && result.ptr == end;
+  } else if constexpr (std::same_as<T, std::string_view>) {
+    out = text;
+    return true;
+  } else if constexpr (std::same_as<T, char const*>) {
+    out = text.data();
+    return true;
+  } else if constexpr (std::same_as<T, std::string>) {
+    out.assign(text);
+    return true;
+  } else if constexpr (is_optional_option<T>) {
+    typename T::value_type value{};
+    if (!parse_option(text, value)) {
+      return false;
+    }
+    out = std::move(value);
+    return true;
+  } else {
+    static_assert(false, "Keyword argument type cannot be parsed from the command line");
+  }
+}
+
+template <typename T>
+constexpr inline bool is_flag_option = std::same_as<T, bool> || std::same_as<T, std::optional<bool>>;
+
+// Per-member tables of an option spec, indexed like the members.
+template <typename Spec>
+struct option_spec {
+  using impl        = typename Spec::type;
+  using parser_type = bool (*)(Spec&, std::string_view);
+
+  static constexpr auto parsers = [:sequence(member_count<impl>):] >> []<std::size_t... Idx> {
+    return std::array<parser_type, sizeof...(Idx)>{
+        +[](Spec& spec, std::string_view text) { return parse_option(text, get<Idx>(spec)); }...};
+  };
+
+  static constexpr auto flags = [:sequence(member_count<impl>):] >> []<std::size_t... Idx> {
+    return std::array<bool, sizeof...(Idx)>{is_flag_option<std::remove_cvref_t<decltype(get<Idx>(std::declval<Spec&>()))>>...};
+  };
+
+  // upper case member names, the suffix of the environment variables
+  static constexpr auto env_names = [:sequence(member_count<impl>):] >> []<std::size_t... Idx> {
+    constexpr auto upper = [](std::string_view name) consteval {
+      std::string result{name};
+      for (char& chr : result) {
+        if (chr >= 'a' && chr <= 'z') {
+          chr = static_cast<char>(chr - 'a' + 'A');
+        }
+      }
+      return std::string_view{std::define_static_string(result), result.size()};
+    };
+    return std::array<std::string_view, sizeof...(Idx)>{upper(member_names<impl>[Idx].name())...};
+  };
+
+  static constexpr std::size_t max_name_size = [] {
+    std::size_t result = 0;
+    for (auto const& name : member_names<impl>) {
+      result = std::max(result, name.size);
+    }
+    return result;
+  }();
+};
+}  // namespace _kwargs_impl
+
+struct parse_error {
+  enum class kind : std::uint8_t {
+    unknown_option,
+    missing_value,
+    invalid_value,
+    unexpected_argument,
+  };
+
+  kind code;
+  // the option or argument as passed, refers into argv (or to the member name for environment variables)
+  std::string_view option;
+  std::string_view value;
+};
+
+struct parse_options {
+  // environment variables named prefix + upper case member name are read
+  // before the command line, empty to disable
+  std::string_view env_prefix = {};
+};
+
+// Parses `--name=value`, `--name value`, `--flag` and `--no-flag` options
+// into a copy of `spec`, the values of which serve as defaults. Dashes in
+// option names match underscores in member names. Parsing stops at `--`,
+// positional arguments are rejected. Strings are stored as views into argv
+// or the environment, only std::string members allocate.
+template <typename Spec>
+  requires(is_kwargs<Spec>)
+std::expected<Spec, parse_error> parse_args(Spec spec, int argc, char const* const* argv, parse_options options = {}) {
+  using impl    = typename Spec::type;
+  using table   = _kwargs_impl::perfect_hash<impl>;
+  using details = _kwargs_impl::option_spec<Spec>;
+  static_assert(std::ranges::none_of(_kwargs_impl::members<impl>,
+                                     [](std::meta::info member) { return is_reference_type(type_of(member)); }),
+                "Option specs cannot borrow their members");
+
+  if constexpr (_kwargs_impl::member_count<impl> != 0) {
+    if (!options.env_prefix.empty()) {
+      std::array<char, 256> name;
+      if (options.env_prefix.size() + details::max_name_size >= name.size()) {
+        throw std::length_error("Environment variable prefix too long.");
+      }
+      auto* suffix = std::ranges::copy(options.env_prefix, name.data()).out;
+
+      for (std::size_t idx = 0; idx < _kwargs_impl::member_count<impl>; ++idx) {
+        *std::ranges::copy(details::env_names[idx], suffix).out = '\0';
+        if (char const* value = std::getenv(name.data()); value != nullptr && !details::parsers[idx](spec, value)) {
+          return std::unexpected(
+              parse_error{parse_error::kind::invalid_value, _kwargs_impl::member_names<impl>[idx].name(), value});
+        }
+      }
+    }
+  }
+
+  for (int arg_idx = 1; arg_idx < argc; ++arg_idx) {
+    std::string_view arg = argv[arg_idx];
+    if (arg == "--") {
+      break;
+    }
+    if (!arg.starts_with("--")) {
+      return std::unexpected(parse_error{parse_error::kind::unexpected_argument, arg, {}});
+    }
+
+    auto separator    = arg.find('=');
+    auto option       = arg.substr(2, separator == std::string_view::npos ? std::string_view::npos : separator - 2);
+    char const* value = separator == std::string_view::npos ? nullptr : argv[arg_idx] + separator + 1;
+
+    auto index   = -1UZ;
+    bool negated = false;
+    if constexpr (_kwargs_impl::member_count<impl> != 0) {
+      std::array<char, details::max_name_size> normalized;
+      auto lookup = [&](std::string_view name) {
+        if (name.size() > normalized.size()) {
+          return -1UZ;
+        }
+        std::ranges::replace_copy(name, normalized.data(), '-', '_');
+        return table::find({normalized.data(), name.size()});
+      };
+
+      index = lookup(option);
+      if (index == -1UZ && value == nullptr && option.starts_with("no-")) {
+        index   = lookup(option.substr(3));
+        negated = index != -1UZ && details::flags[index];
+        if (!negated) {
+          index = -1UZ;
+        }
+      }
+    }
+    if (index == -1UZ) {
+      return std::unexpected(parse_error{parse_error::kind::unknown_option, option, {}});
+    }
+
+    if (value == nullptr) {
+      if (details::flags[index]) {
+        value = negated ? "false" : "true";
+      } else if (arg_idx + 1 < argc) {
+        value = argv[++arg_idx];
+      } else {
+        return std::unexpected(parse_error{parse_error::kind::missing_value, option, {}});
+      }
+    }
+
+    if (!details::parsers[index](spec, value)) {
+      return std::unexpected(parse_error{parse_error::kind::invalid_value, option, value});
+    }
+  }
+  return spec;
+}
+
+// options default to value-initialized members
+template <typename Spec>
+  requires(is_kwargs<Spec>)
+std::expected<Spec, parse_error> parse_args(int argc, char const* const* argv, parse_options options = {}) {
+  return erl::parse_args(Spec{}, argc, argv, options);
+}
+
+}  // namespace erl
@@ -0,0 +1,595 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Binary serialization of packs: serialize, deserialize, serialized_cast and
+// serialized_view. Included by kwargs.h.
+
+#include "config.h"
+#include "core.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+KWARGS_EXPORT namespace erl {
+
+namespace _kwargs_impl {
+template <typename T>
+constexpr inline bool is_vector = false;
+template <typename T, typename A>
+constexpr inline bool is_vector<std::vector<T, A>> = true;
+
+template <typename T>
+constexpr inline bool is_span = false;
+template <typename T>
+constexpr inline bool is_span<std::span<T>> = true;
+
+template <typename T>
+concept is_serialized_string = std::same_as<T, std::string> || std::same_as<T, std::string_view>;
+
+// pointers anywhere in the object representation are meaningless to another process
+consteval bool contains_pointer(std::meta::info type) {
+  type = remove_cv(type);
+  if (is_pointer_type(type) || is_member_pointer_type(type)) {
+    return true;
+  }
+  if (is_array_type(type)) {
+    return contains_pointer(remove_extent(type));
+  }
+  if (is_class_type(type)) {
+    for (auto base : bases_of(type, std::meta::access_context::unchecked())) {
+      if (contains_pointer(type_of(base))) {
+        return true;
+      }
+    }
+    for (auto member : nonstatic_data_members_of(type, std::meta::access_context::unchecked())) {
+      if (contains_pointer(type_of(member))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// values whose object representation is their serialized form
+template <typename T>
+concept is_raw_serializable = std::is_trivially_copyable_v<T> && !is_serialized_string<T> && !is_span<T> &&
+                              !is_kwargs<T> && !contains_pointer(^^T);
+
+// Direct list initialization from an integer is only valid for enums with a
+// fixed underlying type, all values of which are valid enum values.
+template <typename E>
+constexpr inline bool has_fixed_underlying_type = requires { E{std::underlying_type_t<E>{}}; };
+
+// bool and enums without a fixed underlying type do not accept every bit
+// pattern, their bytes are checked before they are read as objects
+consteval bool needs_validation(std::meta::info type) {
+  type = remove_cv(type);
+  if (type == ^^bool) {
+    return true;
+  }
+  if (is_enum_type(type)) {
+    return !extract<bool>(substitute(^^has_fixed_underlying_type, {type}));
+  }
+  if (is_array_type(type)) {
+    return needs_validation(remove_extent(type));
+  }
+  if (is_class_type(type)) {
+    for (auto base : bases_of(type, std::meta::access_context::unchecked())) {
+      if (needs_validation(type_of(base))) {
+        return true;
+      }
+    }
+    for (auto member : nonstatic_data_members_of(type, std::meta::access_context::unchecked())) {
+      if (!is_bit_field(member) && needs_validation(type_of(member))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// values of the smallest bit-field that can hold all enumerators, see [dcl.enum]
+template <typename E>
+consteval std::pair<long long, long long> enum_value_range() {
+  long long low  = 0;
+  long long high = 0;
+  for (auto enumerator : enumerators_of(^^E)) {
+    auto value = static_cast<long long>(extract<E>(enumerator));
+    low        = std::min(low, value);
+    high       = std::max(high, value);
+  }
+  auto width = std::bit_width(static_cast<unsigned long long>(high));
+  if (low < 0) {
+    width = std::max(width, std::bit_width(static_cast<unsigned long long>(~low)));
+  }
+  if (width >= 63) {
+    return {low < 0 ? std::numeric_limits<long long>::min() : 0, std::numeric_limits<long long>::max()};
+  }
+  return {low < 0 ? -(1LL << width) : 0, (1LL << width) - 1};
+}
+
+// whether `bytes` hold a valid object representation of T
+template <typename T>
+bool is_valid_object(std::byte const* bytes) {
+  if constexpr (!needs_validation(^^T)) {
+    return true;
+  } else if constexpr (std::same_as<std::remove_cv_t<T>, bool>) {
+    return std::to_integer<unsigned>(*bytes) <= 1;
+  } else if constexpr (std::is_enum_v<T>) {
+    std::underlying_type_t<T> value;
+    std::memcpy(&value, bytes, sizeof value);
+    constexpr auto range = enum_value_range<std::remove_cv_t<T>>();
+    return static_cast<long long>(value) >= range.first && static_cast<long long>(value) <= range.second;
+  } else if constexpr (std::is_array_v<T>) {
+    using element = std::remove_extent_t<T>;
+    for (std::size_t idx = 0; idx < std::extent_v<T>; ++idx) {
+      if (!is_valid_object<element>(bytes + idx * sizeof(element))) {
+        return false;
+      }
+    }
+    return true;
+  } else {
+    bool valid = true;
+    [:expand(bases_of(^^T, std::meta::access_context::unchecked())):] >>= [&]<auto Base> {
+      valid = valid && is_valid_object<typename[:type_of(Base):]>(bytes + offset_of(Base).bytes);
+    };
+    [:expand(nonstatic_data_members_of(^^T, std::meta::access_context::unchecked())):] >>= [&]<auto Member> {
+      if constexpr (!is_bit_field(Member)) {
+        valid = valid && is_valid_object<typename[:type_of(Member):]>(bytes + offset_of(Member).bytes);
+      }
+    };
+    return valid;
+  }
+}
+
+template <typename T>
+bool are_valid_objects(std::byte const* bytes, std::size_t count) {
+  if constexpr (needs_validation(^^T)) {
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      if (!is_valid_object<T>(bytes + idx * sizeof(T))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+constexpr inline bool is_raw_serializable_v = is_raw_serializable<T>;
+
+// Describes a member type on the wire. Owning and viewing types with the same
+// encoding (std::string and std::string_view, std::vector and std::span) are
+// interchangeable, references are serialized as the value they refer to.
+// Other types are described by kind, size and signedness and classes by their
+// members, never by type names as spelled by the compiler.
+consteval std::string wire_type(std::meta::info type) {
+  type = dealias(remove_cvref(type));
+  if (type == dealias(^^std::string) || type == dealias(^^std::string_view)) {
+    return "string";
+  }
+  if (has_template_arguments(type) &&
+      (template_of(type) == ^^std::vector || template_of(type) == ^^std::span || template_of(type) == ^^kwargs_t)) {
+    auto argument = template_arguments_of(type)[0];
+    if (template_of(type) != ^^kwargs_t) {
+      return "vector<" + wire_type(argument) + ">";
+    }
+    std::string schema = "{";
+    for (auto member : logical_members(argument)) {
+      schema += identifier_of(member);
+      schema += ':';
+      schema += wire_type(type_of(member));
+      schema += ';';
+    }
+    return schema + "}";
+  }
+
+  auto const bits = utos(static_cast<unsigned>(size_of(type) * 8));
+  if (type == ^^bool) {
+    return "bool";
+  }
+  // the signedness of char and wchar_t differs between platforms
+  if (type == ^^char || type == ^^wchar_t || type == ^^char8_t || type == ^^char16_t || type == ^^char32_t) {
+    return "char" + bits;
+  }
+  if (is_integral_type(type)) {
+    return (is_signed_type(type) ? "i" : "u") + bits;
+  }
+  if (is_floating_point_type(type)) {
+    return "f" + bits;
+  }
+  if (is_enum_type(type)) {
+    return "enum<" + wire_type(underlying_type(type)) + ">";
+  }
+  if (is_array_type(type)) {
+    return wire_type(remove_extent(type)) + "[" + utos(static_cast<unsigned>(extent(type))) + "]";
+  }
+  if (is_class_type(type)) {
+    std::string schema = "struct{";
+    for (auto member : nonstatic_data_members_of(type, std::meta::access_context::unchecked())) {
+      if (has_identifier(member)) {
+        schema += identifier_of(member);
+      }
+      auto const offset = offset_of(member);
+      schema += '@';
+      schema += utos(static_cast<unsigned>(offset.bytes * 8 + offset.bits));
+      schema += ':';
+      schema += is_bit_field(member) ? "bits" + utos(static_cast<unsigned>(bit_size_of(member))) : wire_type(type_of(member));
+      schema += ';';
+    }
+    return schema + "}@" + bits;
+  }
+  return "@" + bits;
+}
+
+// Members are serialized in decreasing order of alignment, for packs holding
+// values this matches the declaration order.
+template <typename T>
+consteval std::vector<std::size_t> wire_order() {
+  std::vector<std::size_t> order;
+  for (std::size_t idx = 0; idx < members<T>.size(); ++idx) {
+    order.push_back(idx);
+  }
+  std::ranges::stable_sort(order, std::ranges::greater{}, [](std::size_t idx) {
+    return storage_alignment(remove_cvref(type_of(members<T>[idx])));
+  });
+  return order;
+}
+
+// true if the pack's object representation equals its serialized form
+template <typename T>
+consteval bool is_bulk_serializable() {
+  if (!std::is_trivially_copyable_v<T>) {
+    return false;
+  }
+  std::size_t size = 0;
+  for (auto member : members<T>) {
+    auto type = type_of(member);
+    if (is_reference_type(type) || !extract<bool>(substitute(^^is_raw_serializable_v, {type}))) {
+      return false;
+    }
+    size += size_of(type);
+  }
+  return size == sizeof(T) && declaration_order<T>() == wire_order<T>();
+}
+
+struct serialized_header {
+  std::uint64_t schema;
+  std::uint64_t size;
+};
+
+// Counts bytes if `data` is nullptr, writes them otherwise. Offsets are
+// relative to the start of the payload.
+struct Encoder {
+  std::byte* data    = nullptr;
+  std::size_t offset = 0;
+
+  void write(void const* source, std::size_t size) {
+    if (data != nullptr && size != 0) {
+      std::memcpy(data + offset, source, size);
+    }
+    offset += size;
+  }
+
+  void align(std::size_t alignment) {
+    auto padding = (alignment - offset % alignment) % alignment;
+    if (data != nullptr) {
+      std::memset(data + offset, 0, padding);
+    }
+    offset += padding;
+  }
+};
+
+struct Decoder {
+  std::span<std::byte const> data;
+  std::size_t offset = 0;
+
+  [[nodiscard]] std::byte const* take(std::size_t size) {
+    if (data.size() - offset < size) {
+      return nullptr;
+    }
+    auto const* result = data.data() + offset;
+    offset += size;
+    return result;
+  }
+
+  [[nodiscard]] bool read(void* target, std::size_t size) {
+    auto const* source = take(size);
+    if (source != nullptr && size != 0) {
+      std::memcpy(target, source, size);
+    }
+    return source != nullptr;
+  }
+
+  [[nodiscard]] bool align(std::size_t alignment) {
+    return take((alignment - offset % alignment) % alignment) != nullptr;
+  }
+
+  // like read, but fails on invalid object representations
+  template <typename T>
+  [[nodiscard]] bool read_objects(T* target, std::size_t count) {
+    auto const* source = take(count * sizeof(T));
+    if (source == nullptr || !are_valid_objects<T>(source, count)) {
+      return false;
+    }
+    if (count != 0) {
+      std::memcpy(static_cast<void*>(target), source, count * sizeof(T));
+    }
+    return true;
+  }
+};
+
+template <typename T>
+void encode(Encoder& encoder, T const& value);
+
+template <typename T>
+bool decode(Decoder& decoder, T& value);
+
+template <typename T>
+void encode_sequence(Encoder& encoder, T const* items, std::size_t count) {
+  auto size = static_cast<std::uint64_t>(count);
+  encoder.write(&size, sizeof size);
+  if constexpr (is_raw_serializable<T>) {
+    encoder.align(alignof(T));
+    encoder.write(items, count * sizeof(T));
+  } else {
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      encode(encoder, items[idx]);
+    }
+  }
+}
+
+template <typename T>
+void encode(Encoder& encoder, T const& value) {
+  if constexpr (is_kwargs<T>) {
+    if constexpr (is_bulk_serializable<typename T::type>()) {
+      encoder.write(std::addressof(value), sizeof(T));
+    } else {
+      [:expand(wire_order<typename T::type>()):] >>= [&]<std::size_t Idx> { encode(encoder, get<Idx>(value)); };
+    }
+  } else if constexpr (is_serialized_string<T>) {
+    encode_sequence(encoder, std::string_view{value}.data(), value.size());
+  } else if constexpr (is_vector<T> || is_span<T>) {
+    encode_sequence(encoder, value.data(), value.size());
+  } else {
+    static_assert(!contains_pointer(^^T), "Pointers cannot be serialized");
+    static_assert(is_raw_serializable<T>, "Keyword argument type cannot be serialized");
+    encoder.write(std::addressof(value), sizeof(T));
+  }
+}
+
+template <typename T>
+bool decode(Decoder& decoder, T& value) {
+  if constexpr (is_kwargs<T>) {
+    if constexpr (is_bulk_serializable<typename T::type>()) {
+      return decoder.read_objects(std::addressof(value), 1);
+    } else {
+      return [:expand(wire_order<typename T::type>()):] >> [&]<std::size_t... Idx> {
+        return (decode(decoder, get<Idx>(value)) && ...);
+      };
+    }
+  } else if constexpr (is_serialized_string<T> || is_vector<T> || is_span<T>) {
+    using item_type = std::remove_const_t<typename T::value_type>;
+    std::uint64_t count = 0;
+    if (!decoder.read(&count, sizeof count)) {
+      return false;
+    }
+
+    if constexpr (std::same_as<T, std::string_view> || is_span<T>) {
+      // views refer into the buffer
+      static_assert(is_raw_serializable<item_type>, "Only sequences of trivially copyable values can be viewed");
+      if (!decoder.align(alignof(item_type)) || count > (decoder.data.size() - decoder.offset) / sizeof(item_type)) {
+        return false;
+      }
+      auto const* items = decoder.take(count * sizeof(item_type));
+      if (reinterpret_cast<std::uintptr_t>(items) % alignof(item_type) != 0 ||
+          !are_valid_objects<item_type>(items, static_cast<std::size_t>(count))) {
+        return false;
+      }
+      value = T{reinterpret_cast<item_type const*>(items), static_cast<std::size_t>(count)};
+      return true;
+    } else if constexpr (is_raw_serializable<item_type>) {
+      if (!decoder.align(alignof(item_type)) || count > (decoder.data.size() - decoder.offset) / sizeof(item_type)) {
+        return false;
+      }
+      value.resize(count);
+      return decoder.read_objects(value.data(), static_cast<std::size_t>(count));
+    } else {
+      value.clear();
+      for (std::uint64_t idx = 0; idx < count; ++idx) {
+        if (!decode(decoder, value.emplace_back())) {
+          return false;
+        }
+      }
+      return true;
+    }
+  } else {
+    static_assert(!contains_pointer(^^T), "Pointers cannot be deserialized");
+    static_assert(is_raw_serializable<T>, "Keyword argument type cannot be deserialized");
+    return decoder.read_objects(std::addressof(value), 1);
+  }
+}
+
+// Strings and vectors of trivially copyable values become views into the serialized data.
+template <typename T>
+struct serialized_view_member {
+  using type = T;
+};
+template <>
+struct serialized_view_member<std::string> {
+  using type = std::string_view;
+};
+template <typename T, typename A>
+  requires is_raw_serializable<T>
+struct serialized_view_member<std::vector<T, A>> {
+  using type = std::span<T const>;
+};
+
+template <typename T>
+using serialized_view_member_t = typename serialized_view_member<std::remove_cvref_t<T>>::type;
+
+template <typename T>
+struct serialized_view {
+  struct type;
+  consteval {
+    std::vector<std::meta::info> types;
+    std::vector<std::string_view> names;
+    for (auto member : members<T>) {
+      types.push_back(dealias(substitute(^^serialized_view_member_t, {type_of(member)})));
+      names.push_back(identifier_of(member));
+    }
+    define_aggregate(^^type, pack_members(types, names));
+  }
+};
+
+template <typename T>
+std::optional<T> deserialize(std::span<std::byte const> data, std::uint64_t schema) {
+  serialized_header header;
+  Decoder decoder{data};
+  if (!decoder.read(&header, sizeof header) || header.schema != schema ||
+      header.size > data.size() - sizeof header) {
+    return std::nullopt;
+  }
+
+  T value{};
+  decoder = Decoder{data.subspan(sizeof header, header.size)};
+  if (!decode(decoder, value) || decoder.offset != header.size) {
+    return std::nullopt;
+  }
+  return value;
+}
+}  // namespace _kwargs_impl
+
+// Identifies the serialized layout of a pack: names and types of its members
+// in argument order. Packs borrowing their members share the schema of the
+// corresponding owning pack.
+template <typename T>
+  requires(is_kwargs<T>)
+constexpr inline std::uint64_t schema_hash = _kwargs_impl::hash_name(_kwargs_impl::wire_type(^^T));
+
+// Serialized packs start with a header holding the schema hash and the size of
+// the payload. The payload stores all members in native byte order: trivially
+// copyable values as-is, strings and vectors prefixed by their length. Packs
+// whose object representation equals that are copied in one go.
+template <typename T>
+  requires(is_kwargs<T>)
+std::size_t serialized_size(T const& kwargs) {
+  _kwargs_impl::Encoder encoder;
+  _kwargs_impl::encode(encoder, kwargs);
+  return sizeof(_kwargs_impl::serialized_header) + encoder.offset;
+}
+
+namespace _kwargs_impl {
+// `out` must hold the `size` bytes computed by serialized_size
+template <typename T>
+void write_serialized(T const& kwargs, std::byte* out, std::size_t size) {
+  serialized_header header{schema_hash<T>, size - sizeof(serialized_header)};
+  std::memcpy(out, &header, sizeof header);
+  Encoder encoder{out + sizeof header};
+  encode(encoder, kwargs);
+}
+}  // namespace _kwargs_impl
+
+// returns the number of bytes written, throws std::length_error if `out` is too small
+template <typename T>
+  requires(is_kwargs<T>)
+std::size_t serialize(T const& kwargs, std::span<std::byte> out) {
+  auto size = serialized_size(kwargs);
+  if (out.size() < size) {
+    throw std::length_error("Buffer too small for serialized keyword arguments.");
+  }
+  _kwargs_impl::write_serialized(kwargs, out.data(), size);
+  return size;
+}
+
+// appends to `out`
+template <typename T>
+  requires(is_kwargs<T>)
+void serialize(T const& kwargs, std::vector<std::byte>& out) {
+  auto size   = serialized_size(kwargs);
+  auto offset = out.size();
+  out.resize(offset + size);
+  _kwargs_impl::write_serialized(kwargs, out.data() + offset, size);
+}
+
+// yields nothing if the data was not serialized from a pack with the same schema or is truncated
+template <typename T>
+  requires(is_kwargs<T>)
+std::optional<T> deserialize(std::span<std::byte const> data) {
+  static_assert(std::ranges::none_of(_kwargs_impl::members<typename T::type>,
+                                     [](std::meta::info member) { return is_reference_type(type_of(member)); }),
+                "Cannot deserialize into borrowing keyword arguments");
+  return _kwargs_impl::deserialize<T>(data, schema_hash<T>);
+}
+
+// Pack referring into serialized data, strings are std::string_view and
+// vectors of trivially copyable values std::span.
+template <typename T>
+  requires(is_kwargs<T>)
+using serialized_view_t = kwargs_t<typename _kwargs_impl::serialized_view<typename T::type>::type>;
+
+// Zero-copy read of data serialized from a T, ie. in a memory mapped file or
+// shared memory. The view must not outlive `data`. Fails if the data is
+// misaligned for the viewed sequences.
+template <typename T>
+  requires(is_kwargs<T>)
+std::optional<serialized_view_t<T>> deserialize_view(std::span<std::byte const> data) {
+  return _kwargs_impl::deserialize<serialized_view_t<T>>(data, schema_hash<T>);
+}
+
+// Direct access to a serialized pack whose object representation is its
+// serialized form. Yields nullptr on schema mismatch, truncation, misalignment
+// or invalid bool and enum values.
+template <typename T>
+  requires(is_kwargs<T> && _kwargs_impl::is_bulk_serializable<typename T::type>())
+T const* serialized_cast(std::span<std::byte const> data) {
+  _kwargs_impl::serialized_header header;
+  if (data.size() < sizeof header + sizeof(T)) {
+    return nullptr;
+  }
+  std::memcpy(&header, data.data(), sizeof header);
+  auto const* object = data.data() + sizeof header;
+  if (header.schema != schema_hash<T> || header.size != sizeof(T) ||
+      reinterpret_cast<std::uintptr_t>(object) % alignof(T) != 0 || !_kwargs_impl::is_valid_object<T>(object)) {
+    return nullptr;
+  }
+  return std::launder(reinterpret_cast<T const*>(object));
+}
+
+}  // namespace erl
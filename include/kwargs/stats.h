@@ -0,0 +1,315 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Per call site counters, enabled by KWARGS_STATS. Included by kwargs.h and
+// kwargs/format.h.
+
+#include "config.h"
+
+#if KWARGS_STATS == 1
+#  include <array>
+#  include <atomic>
+#  include <bit>
+#  include <concepts>
+#  include <cstddef>
+#  include <cstdint>
+#  include <cstdio>
+#  include <limits>
+#  include <map>
+#  include <mutex>
+#  include <source_location>
+#  include <string_view>
+#  include <tuple>
+#  if KWARGS_STATS_CYCLES == 1 && !__has_builtin(__builtin_readcyclecounter)
+#    include <chrono>
+#  endif
+
+KWARGS_EXPORT namespace erl {
+
+namespace stats {
+enum class kind { format, invoke };
+
+struct location {
+  std::string_view file;
+  std::string_view function;
+  std::uint_least32_t line;
+  std::uint_least32_t column;
+  // return address of the call for kwargs::invoke, which cannot take a
+  // source location, the other members are empty then
+  std::uintptr_t address = 0;
+};
+
+struct counters {
+  std::uint64_t calls  = 0;
+  std::uint64_t bytes  = 0;
+  std::uint64_t cycles = 0;
+};
+
+// A counted format string or function call site. Sites are constant
+// initialized or created on the first call of a site only known at runtime and
+// link themselves into the registry on their first call.
+struct site {
+  kind category;
+  // the format string or the function name
+  std::string_view name;
+  location where;
+
+  static constexpr std::size_t unregistered = -1UZ;
+  std::atomic<std::size_t> id{unregistered};
+  site* next = nullptr;
+  // used by all threads once KWARGS_STATS_CAPACITY sites are registered
+  std::atomic<std::uint64_t> shared[3]{};
+};
+}  // namespace stats
+
+namespace _kwargs_impl {
+// Counters of one thread, only ever written by their owner. Blocks are never
+// freed, an exiting thread releases its block for reuse so totals survive it.
+struct stats_block {
+  std::array<std::array<std::atomic<std::uint64_t>, 3>, KWARGS_STATS_CAPACITY> slots{};
+  std::atomic<bool> in_use{true};
+  stats_block* next = nullptr;
+};
+
+struct stats_registry {
+  using site_key = std::tuple<stats::kind, std::string_view, std::string_view, std::uint_least32_t, std::uint_least32_t, std::uintptr_t>;
+
+  std::atomic<stats::site*> sites{nullptr};
+  std::atomic<stats_block*> blocks{nullptr};
+  std::size_t site_count = 0;
+  std::mutex registration;
+  // sites created at runtime, never freed
+  std::map<site_key, stats::site*> runtime_sites;
+
+  static stats_registry& instance() {
+    static stats_registry registry;
+    return registry;
+  }
+
+  std::size_t enroll(stats::site& site) {
+    std::lock_guard lock{registration};
+    auto id = site.id.load(std::memory_order_relaxed);
+    if (id == stats::site::unregistered) {
+      id        = site_count++;
+      site.next = sites.load(std::memory_order_relaxed);
+      sites.store(&site, std::memory_order_release);
+      site.id.store(id, std::memory_order_release);
+    }
+    return id;
+  }
+
+  stats::site& site_at(stats::kind kind, std::string_view name, stats::location const& where) {
+    std::lock_guard lock{registration};
+    auto [it, inserted] = runtime_sites.try_emplace(
+        site_key{kind, name, where.file, where.line, where.column, where.address}, nullptr);
+    if (inserted) {
+      it->second = new stats::site{kind, name, where};
+    }
+    return *it->second;
+  }
+
+  stats_block& acquire_block() {
+    for (auto* block = blocks.load(std::memory_order_acquire); block != nullptr; block = block->next) {
+      bool free = false;
+      if (block->in_use.compare_exchange_strong(free, true, std::memory_order_acquire)) {
+        return *block;
+      }
+    }
+    auto* block = new stats_block{};
+    block->next = blocks.load(std::memory_order_relaxed);
+    while (!blocks.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return *block;
+  }
+};
+
+inline stats_block& thread_stats() {
+  struct owner {
+    stats_block& block = stats_registry::instance().acquire_block();
+    ~owner() { block.in_use.store(false, std::memory_order_release); }
+  };
+  thread_local owner current;
+  return current.block;
+}
+
+inline std::uint64_t stats_clock() {
+#if KWARGS_STATS_CYCLES == 1
+#  if __has_builtin(__builtin_readcyclecounter)
+  return __builtin_readcyclecounter();
+#  else
+  return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#  endif
+#else
+  return 0;
+#endif
+}
+
+inline void record_call(stats::site& site, std::uint64_t bytes, std::uint64_t cycles) {
+  auto id = site.id.load(std::memory_order_acquire);
+  if (id == stats::site::unregistered) [[unlikely]] {
+    id = stats_registry::instance().enroll(site);
+  }
+  std::uint64_t const values[3]{1, bytes, cycles};
+  if (id < KWARGS_STATS_CAPACITY) [[likely]] {
+    // single writer, a plain load and store suffices
+    auto& slot = thread_stats().slots[id];
+    for (std::size_t idx = 0; idx < 3; ++idx) {
+      slot[idx].store(slot[idx].load(std::memory_order_relaxed) + values[idx], std::memory_order_relaxed);
+    }
+  } else {
+    for (std::size_t idx = 0; idx < 3; ++idx) {
+      site.shared[idx].fetch_add(values[idx], std::memory_order_relaxed);
+    }
+  }
+}
+
+constexpr stats::location stats_location(std::source_location where) {
+  return {where.file_name(), where.function_name(), where.line(), where.column()};
+}
+
+// Site of a call whose location is only known at runtime, ie. a defaulted
+// source_location parameter. `name` and the strings of `where` must be static.
+// Lookups go through a small per-thread cache, the registry lock is only
+// taken on a miss.
+inline stats::site& stats_site_at(stats::kind kind, std::string_view name, stats::location const& where) {
+  struct entry {
+    char const* name;
+    char const* file;
+    std::uint_least32_t line;
+    std::uint_least32_t column;
+    std::uintptr_t address;
+    stats::site* site;
+  };
+  thread_local std::array<entry, 64> cache{};
+
+  auto const hash = (std::bit_cast<std::uintptr_t>(name.data()) ^ std::bit_cast<std::uintptr_t>(where.file.data()) ^
+                     where.address ^ (std::uintptr_t{where.line} << 12U) ^ where.column) *
+                    0x9e37'79b9'7f4a'7c15ULL;
+  auto& slot = cache[static_cast<std::size_t>(hash >> (std::numeric_limits<decltype(hash)>::digits - 6))];
+  if (slot.site == nullptr || slot.site->category != kind || slot.name != name.data() ||
+      slot.file != where.file.data() || slot.line != where.line || slot.column != where.column ||
+      slot.address != where.address) [[unlikely]] {
+    slot = {name.data(),
+            where.file.data(),
+            where.line,
+            where.column,
+            where.address,
+            &stats_registry::instance().site_at(kind, name, where)};
+  }
+  return *slot.site;
+}
+
+// counts one call on destruction, inactive during constant evaluation
+class stats_scope {
+  stats::site* site = nullptr;
+  std::uint64_t start = 0;
+
+public:
+  std::uint64_t bytes = 0;
+
+  constexpr explicit stats_scope(stats::site& site) : site(&site) {
+    if !consteval {
+      start = stats_clock();
+    }
+  }
+
+  // the site is looked up at runtime only
+  constexpr stats_scope(stats::kind kind, std::string_view name, stats::location const& where) {
+    if !consteval {
+      site  = &stats_site_at(kind, name, where);
+      start = stats_clock();
+    }
+  }
+  stats_scope(stats_scope const&) = delete;
+
+  constexpr ~stats_scope() {
+    if !consteval {
+      record_call(*site, bytes, stats_clock() - start);
+    }
+  }
+};
+
+template <stats::kind Kind,
+          char const* Name,
+          char const* File,
+          char const* Function,
+          std::uint_least32_t Line,
+          std::uint_least32_t Column>
+constinit inline stats::site stats_site_for{Kind, Name, {File, Function, Line, Column}};
+}  // namespace _kwargs_impl
+
+namespace stats {
+// Calls `fnc(site const&, counters const&)` for every site called so far with
+// the counters summed over all threads. Counters are read while other threads
+// keep updating them, each value is exact but they are not a consistent snapshot.
+template <std::invocable<site const&, counters const&> F>
+void for_each(F&& fnc) {
+  auto& registry = _kwargs_impl::stats_registry::instance();
+  for (auto* current = registry.sites.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+    std::uint64_t totals[3]{};
+    auto id = current->id.load(std::memory_order_relaxed);
+    for (std::size_t idx = 0; idx < 3; ++idx) {
+      totals[idx] = current->shared[idx].load(std::memory_order_relaxed);
+    }
+    if (id < KWARGS_STATS_CAPACITY) {
+      for (auto* block = registry.blocks.load(std::memory_order_acquire); block != nullptr; block = block->next) {
+        for (std::size_t idx = 0; idx < 3; ++idx) {
+          totals[idx] += block->slots[id][idx].load(std::memory_order_relaxed);
+        }
+      }
+    }
+    fnc(static_cast<site const&>(*current), counters{totals[0], totals[1], totals[2]});
+  }
+}
+
+// One line per site, ie. `format main.cpp:12:3 calls=10 bytes=230 cycles=0 "{x} {y}"`.
+// kwargs::invoke sites show the return address of the call instead of a source
+// location, `addr2line` maps it back to the caller.
+inline void dump(std::FILE* stream = stderr) {
+  for_each([&](site const& entry, counters const& totals) {
+    std::fprintf(stream, "%s ", entry.category == kind::format ? "format" : "invoke");
+    if (entry.where.address != 0) {
+      std::fprintf(stream, "%#llx", static_cast<unsigned long long>(entry.where.address));
+    } else {
+      std::fprintf(stream,
+                   "%.*s:%u:%u",
+                   static_cast<int>(entry.where.file.size()),
+                   entry.where.file.data(),
+                   static_cast<unsigned>(entry.where.line),
+                   static_cast<unsigned>(entry.where.column));
+    }
+    std::fprintf(stream,
+                 " calls=%llu bytes=%llu cycles=%llu \"%.*s\"\n",
+                 static_cast<unsigned long long>(totals.calls),
+                 static_cast<unsigned long long>(totals.bytes),
+                 static_cast<unsigned long long>(totals.cycles),
+                 static_cast<int>(entry.name.size()),
+                 entry.name.data());
+  });
+}
+}  // namespace stats
+
+}  // namespace erl
+#endif
@@ -0,0 +1,172 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// erl::kwargs_view, a type-erased view of a pack for non-template functions.
+// Included by kwargs.h.
+
+#include "config.h"
+#include "core.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+KWARGS_EXPORT namespace erl {
+
+namespace _kwargs_impl {
+// the address of type_tag<T> identifies T across translation units
+template <typename T>
+constexpr inline char type_tag{};
+
+struct view_member {
+  std::uint64_t hash;
+  std::string_view name;
+  void const* type;
+  void const* (*address)(void const*);
+};
+
+struct view_table {
+  std::span<view_member const> members;
+  // open addressing, member index + 1 or 0 for empty slots
+  std::span<std::uint16_t const> slots;
+};
+
+template <typename T, std::size_t I>
+void const* member_address(void const* object) {
+  return std::addressof(static_cast<T const*>(object)->[:members<T>[I]:]);
+}
+
+template <typename T>
+constexpr inline auto view_members = [:sequence(member_count<T>):] >> []<std::size_t... Idx> {
+  return std::array<view_member, sizeof...(Idx)>{
+      view_member{hash_name(identifier_of(members<T>[Idx])),
+                  std::define_static_string(identifier_of(members<T>[Idx])),
+                  &type_tag<std::remove_cvref_t<typename[:type_of(members<T>[Idx]):]>>,
+                  &member_address<T, Idx>}...};
+};
+
+template <typename T>
+consteval auto make_view_slots() {
+  constexpr std::size_t size = std::bit_ceil(2 * member_count<T> + 1);
+  std::array<std::uint16_t, size> slots{};
+  for (std::size_t idx = 0; idx < member_count<T>; ++idx) {
+    auto slot = view_members<T>[idx].hash & (size - 1);
+    while (slots[slot] != 0) {
+      slot = (slot + 1) & (size - 1);
+    }
+    slots[slot] = static_cast<std::uint16_t>(idx + 1);
+  }
+  return slots;
+}
+
+template <typename T>
+constexpr inline auto view_slots = make_view_slots<T>();
+
+template <typename T>
+constexpr inline view_table view_tables{view_members<T>, view_slots<T>};
+
+constexpr inline std::uint16_t empty_view_slots[1]{};
+constexpr inline view_table empty_view_table{{}, empty_view_slots};
+}  // namespace _kwargs_impl
+
+// Type-erased, non-owning view of a keyword argument pack. Every kwargs_t
+// converts to it, which allows accepting keyword arguments in ordinary
+// (non-template, out-of-line) functions. Lookups hash the name - at compile
+// time for string literals - and probe a table generated for the pack type.
+class kwargs_view {
+public:
+  struct key {
+    std::string_view name;
+    std::uint64_t hash;
+
+    template <std::size_t N>
+    consteval explicit(false) key(char const (&str)[N])
+        : name(str, N - 1)
+        , hash(_kwargs_impl::hash_name(name)) {}
+    constexpr explicit key(std::string_view name)
+        : name(name)
+        , hash(_kwargs_impl::hash_name(name)) {}
+  };
+
+  constexpr kwargs_view() noexcept = default;
+
+  template <typename T>
+    requires is_kwargs<T>
+  constexpr explicit(false) kwargs_view(T const& kwargs) noexcept
+      : object(static_cast<typename T::type const*>(std::addressof(kwargs)))
+      , table(&_kwargs_impl::view_tables<typename T::type>) {}
+
+  [[nodiscard]] std::size_t size() const noexcept { return table->members.size(); }
+  [[nodiscard]] bool contains(key name) const noexcept { return lookup(name) != nullptr; }
+
+  // returns nullptr if the argument is missing or not of type T
+  template <typename T>
+  [[nodiscard]] T const* find(key name) const noexcept {
+    if (auto const* member = lookup(name); member != nullptr && member->type == &_kwargs_impl::type_tag<T>) {
+      return static_cast<T const*>(member->address(object));
+    }
+    return nullptr;
+  }
+
+  template <typename T>
+  [[nodiscard]] T const& get(key name) const {
+    if (auto const* value = find<T>(name)) {
+      return *value;
+    }
+    throw std::out_of_range("Keyword argument `" + std::string(name.name) + "` not found.");
+  }
+
+  template <typename T>
+  [[nodiscard]] T get_or(key name, T default_) const {
+    if (auto const* value = find<T>(name)) {
+      return *value;
+    }
+    return default_;
+  }
+
+private:
+  void const* object                    = nullptr;
+  _kwargs_impl::view_table const* table = &_kwargs_impl::empty_view_table;
+
+  [[nodiscard]] _kwargs_impl::view_member const* lookup(key name) const noexcept {
+    auto const mask = table->slots.size() - 1;
+    for (auto slot = name.hash & mask; table->slots[slot] != 0; slot = (slot + 1) & mask) {
+      auto const& member = table->members[table->slots[slot] - 1];
+      if (member.hash == name.hash && member.name == name.name) {
+        return &member;
+      }
+    }
+    return nullptr;
+  }
+};
+
+}  // namespace erl
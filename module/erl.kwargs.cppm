@@ -0,0 +1,53 @@
+// Module interface for the core of kwargs, equivalent to <kwargs/core.h>.
+// Macros are not exported, include <kwargs/macros.h> after `import erl.kwargs;`
+// to use make_args and make_args_ref.
+module;
+
+// The standard library goes into the global module fragment. Include guards
+// keep the header below from including it again within the module purview.
+#define KWARGS_EXPORT export
+#include <kwargs/config.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <meta>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if KWARGS_STATS == 1
+#  include <atomic>
+#  include <cstdio>
+#  include <map>
+#  include <mutex>
+#  include <source_location>
+#  include <chrono>
+#endif
+
+export module erl.kwargs;
+
+#include <kwargs/core.h>
+#include <kwargs/view.h>
+#include <kwargs/serialize.h>
+#include <kwargs/lookup.h>
+#include <kwargs/parse_args.h>
+#include <kwargs/stats.h>
+#include <kwargs/invoke.h>
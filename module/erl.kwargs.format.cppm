@@ -0,0 +1,74 @@
+// Module interface for named formatting, equivalent to <kwargs/format.h>.
+// Re-exports erl.kwargs.
+module;
+
+#define KWARGS_EXPORT      export
+#define KWARGS_IMPORT_CORE 1
+#include <kwargs/config.h>
+
+// Declarations from the global module fragment of erl.kwargs are not visible
+// here, format.h needs the standard headers of the core as well as its own.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <expected>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <meta>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if KWARGS_STATS == 1
+#  include <atomic>
+#  include <chrono>
+#  include <map>
+#  include <mutex>
+#  include <source_location>
+#endif
+
+#if KWARGS_SINKS == 1 || KWARGS_LOGGING == 1
+#  include <atomic>
+#  include <cerrno>
+#  include <chrono>
+#  include <climits>
+#  include <condition_variable>
+#  include <mutex>
+#  include <new>
+#  include <ostream>
+#  include <stop_token>
+#  include <thread>
+#  if __has_include(<sys/uio.h>)
+#    include <sys/uio.h>
+#  endif
+#endif
+
+export module erl.kwargs.format;
+
+export import erl.kwargs;
+
+#include <kwargs/format.h>
@@ -1,4 +1,10 @@
+#include <cstdio>
+#include <format>
+#include <iterator>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 
 #define KWARGS_FORMATTING 1
@@ -6,7 +12,133 @@
 
 using namespace std::string_view_literals;
 
+namespace {
+// runtime calls of std::formatter<Celsius>::parse
+int celsius_parses = 0;
+}  // namespace
+
+struct Celsius {
+  double value;
+};
+
+template <>
+struct std::formatter<Celsius> : std::formatter<double> {
+  constexpr auto parse(std::format_parse_context& context) {
+    if !consteval {
+      ++celsius_parses;
+    }
+    return std::formatter<double>::parse(context);
+  }
+
+  auto format(Celsius const& celsius, std::format_context& context) const {
+    auto out = std::formatter<double>::format(celsius.value, context);
+    *out++   = 'C';
+    return out;
+  }
+};
+
 TEST(Format, Formatting){
   EXPECT_EQ(erl::format("{foo} {bar}", make_args(foo=1, bar=2)), "1 2"sv);
   EXPECT_EQ(erl::format("{bar} {foo}", make_args(foo=1, bar=2)), "2 1"sv);
-}
\ No newline at end of file
+}
+
+TEST(Format, FormatTo) {
+  std::string out;
+  erl::format_to(std::back_inserter(out), "{foo}-{bar}", make_args(foo=1, bar="x"));
+  EXPECT_EQ(out, "1-x"sv);
+
+  char buffer[16]{};
+  auto* end = erl::format_to(buffer, "{bar}{foo}", make_args(foo=23, bar=4));
+  EXPECT_EQ(std::string_view(buffer, end), "423"sv);
+}
+
+TEST(Format, FormatToN) {
+  char buffer[4]{};
+  auto result = erl::format_to_n(buffer, 3, "{foo} {bar}", make_args(foo=12345, bar=6));
+  EXPECT_EQ(result.size, 7);
+  EXPECT_EQ(std::string_view(buffer, result.out), "123"sv);
+}
+
+TEST(Format, FormattedSize) {
+  EXPECT_EQ(erl::formatted_size("{foo} {bar}", make_args(foo=1, bar=234)), 5);
+  EXPECT_EQ(erl::formatted_size("{foo}", make_args(foo=std::string(1000, 'x'))), 1000);
+}
+
+TEST(Format, LongOutput) {
+  auto long_string = std::string(2000, 'x');
+  EXPECT_EQ(erl::format("{foo}{bar}", make_args(foo=long_string, bar=1)), long_string + "1");
+}
+
+TEST(Format, Print) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+
+  erl::print(file, "{foo} ", make_args(foo=1));
+  erl::println(file, "{bar}", make_args(bar=std::string(1000, 'y')));
+  erl::println(file, "{} {}", 2, 3);
+
+  std::string contents(std::size_t(std::ftell(file)), '\0');
+  std::rewind(file);
+  ASSERT_EQ(std::fread(contents.data(), 1, contents.size(), file), contents.size());
+  std::fclose(file);
+
+  EXPECT_EQ(contents, "1 " + std::string(1000, 'y') + "\n2 3\n");
+}
+
+TEST(Format, PrintLinesAreAtomic) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    // longer than the FileBuffer storage, every line takes several writes
+    std::vector<std::jthread> threads;
+    for (char chr : {'a', 'b', 'c', 'd'}) {
+      threads.emplace_back([file, chr] {
+        for (int idx = 0; idx < 100; ++idx) {
+          erl::println(file, "{line}", make_args(line = std::string(2000, chr)));
+        }
+      });
+    }
+  }
+
+  std::string contents(std::size_t(std::ftell(file)), '\0');
+  std::rewind(file);
+  ASSERT_EQ(std::fread(contents.data(), 1, contents.size(), file), contents.size());
+  std::fclose(file);
+
+  ASSERT_EQ(contents.size(), 4 * 100 * 2001);
+  for (std::size_t offset = 0; offset < contents.size(); offset += 2001) {
+    auto line = std::string_view(contents).substr(offset, 2001);
+    EXPECT_EQ(line.find_first_not_of(line[0]), 2000);
+    EXPECT_EQ(line.back(), '\n');
+  }
+}
+
+TEST(Format, Plan) {
+  EXPECT_EQ(erl::format("{{{x}}}", make_args(x=1)), "{1}"sv);
+  EXPECT_EQ(erl::format("}}{x}{{", make_args(x=1)), "}1{"sv);
+  EXPECT_EQ(erl::format("{x}", make_args(x=-42LL)), "-42"sv);
+  EXPECT_EQ(erl::format("{x} {y} {z}", make_args(x=0.1, y=true, z='c')), "0.1 true c"sv);
+  EXPECT_EQ(erl::format("{s}/{v}", make_args(s=std::string("str"), v="view"sv)), "str/view"sv);
+  EXPECT_EQ(erl::format("{x:>4}|{y:.2f}|{x:#x}", make_args(x=7, y=3.14159)), "   7|3.14|0x7"sv);
+}
+
+TEST(Format, PlanNested) {
+  // nested replacement fields refer to other members
+  EXPECT_EQ(erl::format("{x:{w}}", make_args(x=5, w=3)), "  5"sv);
+  EXPECT_EQ(erl::format("{x:.{p}f}|{x:{w}.{p}}", make_args(x=0.5, w=5, p=2)), "0.50|  0.5"sv);
+}
+
+TEST(Format, PlanSpecFields) {
+  // Plain fields are written directly, spec fields by a formatter parsed
+  // once: at compile time, or on the first call for nested replacement fields.
+  std::string out;
+  for (int idx = 0; idx < 3; ++idx) {
+    out += erl::format("{id}:{t:.1f}|{name}|{t:>{w}.{p}f}|{id:03}\n",
+                       make_args(id = idx, t = Celsius{idx + 0.5}, name = "n"sv, w = 8, p = 2));
+  }
+  EXPECT_EQ(out,
+            "0:0.5C|n|    0.50C|000\n"
+            "1:1.5C|n|    1.50C|001\n"
+            "2:2.5C|n|    2.50C|002\n"sv);
+  EXPECT_EQ(celsius_parses, 1);
+}
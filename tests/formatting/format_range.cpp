@@ -0,0 +1,133 @@
+#include <format>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+#define KWARGS_FORMATTING 1
+#include <kwargs.h>
+
+struct Faulty {
+  int value;
+};
+
+template <>
+struct std::formatter<Faulty> : std::formatter<int> {
+  auto format(Faulty const& faulty, std::format_context& ctx) const {
+    if (faulty.value < 0) {
+      throw std::runtime_error("faulty");
+    }
+    return std::formatter<int>::format(faulty.value, ctx);
+  }
+};
+
+namespace {
+auto record(int id, std::string_view name, double value) {
+  return make_args(id, name, value);
+}
+using record_t = decltype(record(0, {}, 0));
+
+auto faulty(Faulty value) {
+  return make_args(value);
+}
+using faulty_t = decltype(faulty({}));
+
+std::vector<record_t> records(int count) {
+  std::vector<record_t> result;
+  for (int idx = 0; idx < count; ++idx) {
+    result.push_back(record(idx, idx % 2 == 0 ? "even" : "odd", idx * 0.5));
+  }
+  return result;
+}
+
+std::string formatted_one_by_one(std::vector<record_t> const& input) {
+  std::string result;
+  for (auto const& entry : input) {
+    result += erl::format("{id};{name};{value}", entry);
+    result += '\n';
+  }
+  return result;
+}
+}  // namespace
+
+TEST(FormatRange, Sequential) {
+  auto input = records(100);
+  std::string out;
+  erl::format_range("{id};{name};{value}", input, out);
+  EXPECT_EQ(out, formatted_one_by_one(input));
+
+  // appends and uses the given terminator
+  std::string csv = "id,name\n";
+  erl::format_range("{id},{name}", input | std::views::take(2), csv, {.terminator = "\r\n"});
+  EXPECT_EQ(csv, "id,name\n0,even\r\n1,odd\r\n");
+
+  std::string empty;
+  erl::format_range("{id}", std::vector<record_t>{}, empty);
+  EXPECT_EQ(empty, "");
+}
+
+TEST(FormatRange, Parallel) {
+  auto input    = records(10'007);
+  auto expected = formatted_one_by_one(input);
+
+  for (unsigned threads : {0U, 2U, 3U, 8U}) {
+    std::string out = "header\n";
+    erl::format_range("{id};{name};{value}", input, out, {.threads = threads, .min_records_per_thread = 1});
+    EXPECT_EQ(out, "header\n" + expected) << threads;
+  }
+
+  // small ranges stay on the calling thread
+  std::string out;
+  erl::format_range("{id};{name};{value}", input, out, {.threads = 4, .min_records_per_thread = 100'000});
+  EXPECT_EQ(out, expected);
+
+  // ranges without random access are formatted sequentially
+  out.clear();
+  erl::format_range("{id};{name};{value}", input | std::views::filter([](auto const&) { return true; }), out,
+                    {.threads = 4, .min_records_per_thread = 1});
+  EXPECT_EQ(out, expected);
+}
+
+TEST(FormatRange, ConcurrentCalls) {
+  auto input    = records(4'001);
+  auto expected = formatted_one_by_one(input);
+
+  // calls from several threads share the pool, calls from one thread reuse it
+  std::vector<std::string> outputs(4);
+  {
+    std::vector<std::jthread> callers;
+    for (auto& out : outputs) {
+      callers.emplace_back([&] {
+        for (int repeat = 0; repeat < 10; ++repeat) {
+          out.clear();
+          erl::format_range("{id};{name};{value}", input, out, {.threads = 0, .min_records_per_thread = 1});
+        }
+      });
+    }
+  }
+  for (auto const& out : outputs) {
+    EXPECT_EQ(out, expected);
+  }
+}
+
+TEST(FormatRange, Exception) {
+  std::vector<faulty_t> input;
+  for (int idx = 0; idx < 1000; ++idx) {
+    input.push_back(faulty({idx}));
+  }
+
+  // thrown on the calling thread, on a worker and sequentially
+  for (auto [position, threads] : {std::pair{0, 4U}, std::pair{999, 4U}, std::pair{500, 1U}}) {
+    input[position] = faulty({-1});
+    std::string out = "header\n";
+    EXPECT_THROW(erl::format_range("{value}", input, out, {.threads = threads, .min_records_per_thread = 1}),
+                 std::runtime_error);
+    // nothing of the failed call remains in `out`
+    EXPECT_EQ(out, "header\n");
+    input[position] = faulty({position});
+  }
+}
@@ -0,0 +1,44 @@
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <gtest/gtest.h>
+
+#define KWARGS_FORMATTING 1
+#include <kwargs.h>
+
+using namespace std::string_view_literals;
+
+TEST(FormatInline, Bound) {
+  auto result = erl::format_inline<"{x}:{y}">(make_args(x = 1, y = std::uint8_t{2}));
+  static_assert(decltype(result)::capacity == 11 + 1 + 3);
+  EXPECT_EQ(result.view(), "1:2");
+  EXPECT_STREQ(result.c_str(), "1:2");
+  EXPECT_FALSE(result.truncated());
+}
+
+TEST(FormatInline, Extremes) {
+  // values with the longest representation of their type stay within the bound
+  auto min      = std::numeric_limits<std::int64_t>::min();
+  auto subnorm  = -std::numeric_limits<double>::denorm_min() * 4503599627370495.0;
+  auto fsubnorm = -std::numeric_limits<float>::min() * 0.99999988f;
+  auto result   = erl::format_inline<"{min}|{subnorm}|{fsubnorm}|{flag}|{c}">(
+      make_args(min, subnorm, fsubnorm, flag = false, c = '}'));
+  auto expected = std::format("{}|{}|{}|false|}}", min, subnorm, fsubnorm);
+  EXPECT_EQ(result.view(), expected);
+  EXPECT_EQ(decltype(result)::capacity, 20 + 1 + 24 + 1 + 15 + 1 + 5 + 1 + 1);
+  EXPECT_LE(expected.size(), decltype(result)::capacity);
+}
+
+TEST(FormatInline, Capacity) {
+  auto result = erl::format_inline<"{name}={value:>6}", 32>(make_args(name = "cpu"sv, value = 42));
+  static_assert(decltype(result)::capacity == 32);
+  EXPECT_EQ(result.view(), "cpu=    42");
+  EXPECT_FALSE(result.truncated());
+
+  auto cut = erl::format_inline<"{name}", 4>(make_args(name = std::string(100, 'x')));
+  EXPECT_TRUE(cut.truncated());
+  EXPECT_EQ(cut.view(), "xxxx");
+  EXPECT_STREQ(cut.c_str(), "xxxx");
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#define KWARGS_FORMATTING 1
+#define KWARGS_LOGGING 1
+#include <kwargs.h>
+
+using namespace std::string_view_literals;
+
+namespace {
+std::string read_all(std::FILE* file) {
+  std::string contents(std::size_t(std::ftell(file)), '\0');
+  std::rewind(file);
+  std::fread(contents.data(), 1, contents.size(), file);
+  return contents;
+}
+
+std::vector<std::string> lines(std::string_view text) {
+  std::vector<std::string> result;
+  for (auto line : text | std::views::split('\n')) {
+    if (!line.empty()) {
+      result.emplace_back(line.begin(), line.end());
+    }
+  }
+  return result;
+}
+}  // namespace
+
+TEST(Log, Deferred) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    erl::Logger logger{file};
+    int id = 3;
+    logger.log("req {id} took {us}us", make_args(id, us = 1.5));
+    logger.log("{x:>4}|{y}", make_args(x = 7, y = true));
+  }
+  EXPECT_EQ(read_all(file), "req 3 took 1.5us\n   7|true\n");
+  std::fclose(file);
+}
+
+TEST(Log, StringsByValue) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    erl::Logger logger{file};
+    std::string name = "first";
+    auto args        = make_args_ref(name);
+    logger.log("{name}", args);
+    name = "second";
+    logger.log("{name} {view} {ptr}", make_args(name, view = "view"sv, ptr = "ptr"));
+    logger.flush();
+    EXPECT_EQ(read_all(file), "first\nsecond view ptr\n");
+    std::fseek(file, 0, SEEK_END);
+  }
+  std::fclose(file);
+}
+
+TEST(Log, Truncation) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    erl::Logger logger{file, 256};
+    logger.log("{text}", make_args(text = std::string(1000, 'x')));
+  }
+  auto contents = read_all(file);
+  ASSERT_FALSE(contents.empty());
+  EXPECT_LT(contents.size(), 256 + " [truncated]"sv.size());
+  // the cut is marked in the output
+  auto const cut = contents.find_first_not_of('x');
+  ASSERT_NE(cut, 0);
+  EXPECT_EQ(contents.substr(cut), " [truncated]\n");
+  std::fclose(file);
+}
+
+TEST(Log, WrapLargeRecord) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    // the second record needs padding that together with the record exceeds the ring
+    erl::Logger logger{file, 256};
+    logger.log("{x}", make_args(x = 1));
+    logger.log("{text}", make_args(text = std::string(1000, 'x')));
+  }
+  auto records = lines(read_all(file));
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0], "1");
+  EXPECT_TRUE(records[1].ends_with(" [truncated]"));
+  EXPECT_EQ(records[1].find_first_not_of('x'), records[1].size() - " [truncated]"sv.size());
+  std::fclose(file);
+}
+
+TEST(Log, NotTruncated) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    erl::Logger logger{file, 256};
+    logger.log("{text}", make_args(text = std::string(100, 'x')));
+  }
+  EXPECT_EQ(read_all(file), std::string(100, 'x') + "\n");
+  std::fclose(file);
+}
+
+TEST(Log, Alternating) {
+  std::FILE* first  = std::tmpfile();
+  std::FILE* second = std::tmpfile();
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  {
+    erl::Logger a{first};
+    erl::Logger b{second};
+    for (int idx = 0; idx < 3; ++idx) {
+      a.log("a{idx}", make_args(idx));
+      b.log("b{idx}", make_args(idx));
+    }
+  }
+  EXPECT_EQ(read_all(first), "a0\na1\na2\n");
+  EXPECT_EQ(read_all(second), "b0\nb1\nb2\n");
+  std::fclose(first);
+  std::fclose(second);
+}
+
+TEST(Log, Threads) {
+  constexpr int thread_count = 4;
+  constexpr int per_thread   = 1000;
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    // small rings force wrap-around and producers waiting for the worker
+    erl::Logger logger{file, 1024};
+    std::vector<std::jthread> threads;
+    for (int thread = 0; thread < thread_count; ++thread) {
+      threads.emplace_back([&logger, thread] {
+        for (int idx = 0; idx < per_thread; ++idx) {
+          logger.log("{thread} {idx}", make_args(thread, idx));
+        }
+      });
+    }
+  }
+
+  std::vector<int> next(thread_count, 0);
+  auto records = lines(read_all(file));
+  ASSERT_EQ(records.size(), thread_count * per_thread);
+  for (auto const& record : records) {
+    int thread = 0;
+    int idx    = 0;
+    ASSERT_EQ(std::sscanf(record.c_str(), "%d %d", &thread, &idx), 2);
+    // records of one thread keep their order
+    EXPECT_EQ(idx, next[thread]++);
+  }
+  std::fclose(file);
+}
@@ -0,0 +1,136 @@
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#define KWARGS_FORMATTING 1
+#define KWARGS_SINKS 1
+#include <kwargs.h>
+
+namespace {
+std::vector<std::string_view> lines_of(std::string_view text) {
+  std::vector<std::string_view> lines;
+  while (!text.empty()) {
+    auto end = text.find('\n');
+    lines.push_back(text.substr(0, end));
+    text.remove_prefix(end == text.npos ? text.size() : end + 1);
+  }
+  return lines;
+}
+
+std::string read_all(std::FILE* file) {
+  std::string contents(std::size_t(std::ftell(file)), '\0');
+  std::rewind(file);
+  std::fread(contents.data(), 1, contents.size(), file);
+  return contents;
+}
+}  // namespace
+
+TEST(Sink, Buffering) {
+  erl::MemorySink sink{{.batch_size = 16, .max_delay = {}}};
+  erl::print(sink, "{x}", make_args(x = 1));
+  erl::println(sink, "-{y}", make_args(y = 2));
+  EXPECT_EQ(sink.str(), "");
+
+  // the batch is handed over as a whole once it is full
+  erl::println(sink, "{text}", make_args(text = std::string_view{"0123456789abcdef"}));
+  EXPECT_EQ(sink.str(), "1-2\n0123456789abcdef\n");
+
+  erl::println(sink, "{x}", make_args(x = 3));
+  sink.flush();
+  EXPECT_EQ(sink.str(), "1-2\n0123456789abcdef\n3\n");
+}
+
+TEST(Sink, Alternating) {
+  // one thread switching between sinks keeps a cached buffer for each of them
+  std::vector<std::unique_ptr<erl::MemorySink>> sinks;
+  for (int idx = 0; idx < 20; ++idx) {
+    sinks.push_back(std::make_unique<erl::MemorySink>(erl::Sink::options{.max_delay = {}}));
+  }
+  for (int round = 0; round < 3; ++round) {
+    for (std::size_t idx = 0; idx < sinks.size(); ++idx) {
+      erl::println(*sinks[idx], "{idx}:{round}", make_args(idx, round));
+    }
+  }
+  for (std::size_t idx = 0; idx < sinks.size(); ++idx) {
+    sinks[idx]->flush();
+    auto prefix = std::to_string(idx) + ":";
+    EXPECT_EQ(sinks[idx]->str(), prefix + "0\n" + prefix + "1\n" + prefix + "2\n");
+  }
+}
+
+TEST(Sink, Delay) {
+  erl::MemorySink sink{{.max_delay = std::chrono::milliseconds{1}}};
+  erl::println(sink, "{x}", make_args(x = 1));
+  for (int attempt = 0; attempt < 1000 && sink.str().empty(); ++attempt) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(sink.str(), "1\n");
+}
+
+TEST(Sink, Concurrent) {
+  constexpr int threads = 4;
+  constexpr int lines   = 2000;
+
+  erl::MemorySink sink{{.batch_size = 256}};
+  {
+    std::vector<std::jthread> writers;
+    for (int thread = 0; thread < threads; ++thread) {
+      writers.emplace_back([&, thread] {
+        for (int line = 0; line < lines; ++line) {
+          erl::println(sink, "thread={thread} line={line} end", make_args(thread, line));
+        }
+      });
+    }
+  }
+  sink.flush();
+
+  // every line is intact and the lines of one thread keep their order
+  std::map<int, int> next;
+  auto output = sink.str();
+  for (auto line : lines_of(output)) {
+    int thread = -1;
+    int index  = -1;
+    ASSERT_EQ(std::sscanf(std::string{line}.c_str(), "thread=%d line=%d end", &thread, &index), 2) << line;
+    ASSERT_TRUE(line.ends_with(" end")) << line;
+    EXPECT_EQ(next[thread]++, index);
+  }
+  EXPECT_EQ(next.size(), threads);
+  for (auto [thread, count] : next) {
+    EXPECT_EQ(count, lines);
+  }
+}
+
+TEST(Sink, Destinations) {
+  std::ostringstream stream;
+  {
+    erl::StreamSink sink{stream};
+    erl::println(sink, "stream {x}", make_args(x = 1));
+  }
+  EXPECT_EQ(stream.str(), "stream 1\n");
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    erl::FileSink sink{file};
+    erl::println(sink, "file {x}", make_args(x = 2));
+  }
+  EXPECT_EQ(read_all(file), "file 2\n");
+  std::fclose(file);
+
+  file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  {
+    erl::FdSink sink{fileno(file)};
+    erl::println(sink, "fd {x}", make_args(x = 3));
+    erl::println(sink, "fd {x}", make_args(x = 4));
+  }
+  std::fseek(file, 0, SEEK_END);
+  EXPECT_EQ(read_all(file), "fd 3\nfd 4\n");
+  std::fclose(file);
+}
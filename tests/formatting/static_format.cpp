@@ -0,0 +1,49 @@
+#include <string>
+#include <string_view>
+#include <gtest/gtest.h>
+
+#define KWARGS_FORMATTING 1
+#include <kwargs.h>
+
+using namespace std::string_view_literals;
+
+namespace {
+constexpr std::string_view metric = erl::static_format<"{svc}.{metric}.count">(make_args(svc = "api", metric = "req"));
+static_assert(metric == "api.req.count");
+
+static_assert(erl::static_format<"{{{a}}} {b} {c} {d}">(make_args(a = -42, b = true, c = 'x', d = 18446744073709551615ULL))
+                  .view() == "{-42} true x 18446744073709551615");
+static_assert(erl::static_format<"{name}">(make_args(name = ""sv)).is_static());
+
+erl::formatting::StaticFormatResult const& banner(int build) {
+  static auto const result = erl::static_format<"v{major}.{minor} build {build}">(make_args(major = 1, minor = 2, build));
+  return result;
+}
+}  // namespace
+
+TEST(StaticFormat, Constant) {
+  static auto const result = erl::static_format<"{svc}-{id}">(make_args(svc = "api"sv, id = 7));
+  EXPECT_TRUE(result.is_static());
+  EXPECT_EQ(result.view(), "api-7");
+}
+
+TEST(StaticFormat, Runtime) {
+  int id      = 7;
+  auto result = erl::static_format<"{svc}-{id}">(make_args(svc = "api"sv, id));
+  EXPECT_FALSE(result.is_static());
+  EXPECT_EQ(result.view(), "api-7");
+
+  EXPECT_FALSE(banner(3).is_static());
+  EXPECT_EQ(std::string_view{banner(3)}, "v1.2 build 3");
+}
+
+TEST(StaticFormat, Unsupported) {
+  // floating point and format specs are formatted at runtime, even with constant arguments
+  static auto const ratio = erl::static_format<"{ratio}">(make_args(ratio = 0.5));
+  EXPECT_FALSE(ratio.is_static());
+  EXPECT_EQ(ratio.view(), "0.5");
+
+  static auto const padded = erl::static_format<"{id:>4}">(make_args(id = 7));
+  EXPECT_FALSE(padded.is_static());
+  EXPECT_EQ(padded.view(), "   7");
+}
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#define KWARGS_FORMATTING 1
+#include <kwargs.h>
+
+namespace {
+erl::stats::counters totals_for(std::string_view name, erl::stats::site const** found = nullptr) {
+  erl::stats::counters result;
+  erl::stats::for_each([&](erl::stats::site const& site, erl::stats::counters const& totals) {
+    if (site.name == name) {
+      result = totals;
+      if (found != nullptr) {
+        *found = &site;
+      }
+    }
+  });
+  return result;
+}
+
+// calls per site, sorted
+std::vector<std::uint64_t> calls_per_site(std::string_view name) {
+  std::vector<std::uint64_t> calls;
+  erl::stats::for_each([&](erl::stats::site const& site, erl::stats::counters const& totals) {
+    if (site.name == name) {
+      calls.push_back(totals.calls);
+    }
+  });
+  std::ranges::sort(calls);
+  return calls;
+}
+
+std::string greet(int id) {
+  return erl::format("stats test {id}", make_args(id));
+}
+}  // namespace
+
+TEST(Stats, Format) {
+  EXPECT_EQ(totals_for("stats test {id}").calls, 0);
+
+  EXPECT_EQ(greet(1), "stats test 1");
+  EXPECT_EQ(greet(23), "stats test 23");
+  std::jthread{[] { greet(456); }}.join();
+
+  erl::stats::site const* site = nullptr;
+  auto totals                  = totals_for("stats test {id}", &site);
+  ASSERT_NE(site, nullptr);
+  EXPECT_EQ(site->category, erl::stats::kind::format);
+  EXPECT_TRUE(site->where.file.ends_with("stats.cpp"));
+  EXPECT_EQ(totals.calls, 3);
+  EXPECT_EQ(totals.bytes, 12 + 13 + 14);
+}
+
+TEST(Stats, CallSites) {
+  auto args = make_args(x = 1);
+  for (int idx = 0; idx < 2; ++idx) {
+    (void)erl::format("stats site {x}", args);
+  }
+  (void)erl::format("stats site {x}", args);
+
+  EXPECT_EQ(calls_per_site("stats site {x}"), (std::vector<std::uint64_t>{1, 2}));
+}
+
+TEST(Stats, InlineCallSites) {
+  auto args = make_args(x = 1);
+  for (int idx = 0; idx < 2; ++idx) {
+    (void)erl::format_inline<"stats inline {x}">(args);
+    (void)erl::static_format<"stats static {x}">(args);
+  }
+  (void)erl::format_inline<"stats inline {x}">(args);
+  (void)erl::static_format<"stats static {x}">(args);
+
+  EXPECT_EQ(calls_per_site("stats inline {x}"), (std::vector<std::uint64_t>{1, 2}));
+  EXPECT_EQ(calls_per_site("stats static {x}"), (std::vector<std::uint64_t>{1, 2}));
+
+  erl::stats::site const* site = nullptr;
+  auto totals                  = totals_for("stats inline {x}", &site);
+  ASSERT_NE(site, nullptr);
+  EXPECT_TRUE(site->where.file.ends_with("stats.cpp"));
+  EXPECT_EQ(totals.bytes, totals.calls * 14);
+  totals_for("stats static {x}", &site);
+  EXPECT_TRUE(site->where.file.ends_with("stats.cpp"));
+}
+
+TEST(Stats, Dump) {
+  (void)erl::format("stats dump {x}", make_args(x = 1));
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  erl::stats::dump(file);
+  std::string contents(std::size_t(std::ftell(file)), '\0');
+  std::rewind(file);
+  std::fread(contents.data(), 1, contents.size(), file);
+  std::fclose(file);
+
+  EXPECT_NE(contents.find("calls=1 bytes=12"), std::string::npos);
+  EXPECT_NE(contents.find("\"stats dump {x}\""), std::string::npos);
+}
+
+#if __has_feature(parameter_reflection)
+namespace {
+int stats_add(int x, int y) {
+  return x + y;
+}
+
+int stats_sub(int x, int y) {
+  return x - y;
+}
+}  // namespace
+
+TEST(Stats, Invoke) {
+  EXPECT_EQ(erl::kwargs::invoke<^^stats_add>(make_args(x = 1, y = 2)), 3);
+  EXPECT_EQ(erl::kwargs::invoke<^^stats_add>(1, make_args(y = 2)), 3);
+  auto add_two = erl::kwargs::bind<^^stats_add>(make_args(y = 2));
+  EXPECT_EQ(add_two(1), 3);
+  EXPECT_EQ(add_two(5), 7);
+
+  // two invoke call sites and the bind site
+  EXPECT_EQ(calls_per_site("stats_add"), (std::vector<std::uint64_t>{1, 1, 2}));
+  erl::stats::for_each([&](erl::stats::site const& site, erl::stats::counters const& totals) {
+    if (site.name != "stats_add") {
+      return;
+    }
+    EXPECT_EQ(site.category, erl::stats::kind::invoke);
+    EXPECT_EQ(totals.bytes, 0);
+    if (totals.calls == 2) {
+      EXPECT_TRUE(site.where.file.ends_with("stats.cpp"));
+      EXPECT_EQ(site.where.address, 0);
+    } else {
+      EXPECT_NE(site.where.address, 0);
+    }
+  });
+}
+
+TEST(Stats, InvokeCallSites) {
+  for (int idx = 0; idx < 3; ++idx) {
+    EXPECT_EQ(erl::kwargs::invoke<^^stats_sub>(idx, make_args(y = 1)), idx - 1);
+  }
+  EXPECT_EQ(erl::kwargs::invoke<^^stats_sub>(2, make_args(y = 1)), 1);
+
+  EXPECT_EQ(calls_per_site("stats_sub"), (std::vector<std::uint64_t>{1, 3}));
+}
+#endif
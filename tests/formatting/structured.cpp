@@ -0,0 +1,57 @@
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gtest/gtest.h>
+
+#define KWARGS_FORMATTING 1
+#include <kwargs.h>
+
+using namespace std::string_view_literals;
+
+TEST(Structured, Json) {
+  EXPECT_EQ(erl::to_json(make_args()), "{}"sv);
+  EXPECT_EQ(erl::to_json(make_args(id=42, ok=true, ratio=0.5, name="req")),
+            R"({"id":42,"ok":true,"ratio":0.5,"name":"req"})"sv);
+  EXPECT_EQ(erl::to_json(make_args(c='x', none=std::optional<int>{}, some=std::optional<int>{3})),
+            R"({"c":"x","none":null,"some":3})"sv);
+  EXPECT_EQ(erl::to_json(make_args(items=std::vector<int>{1, 2}, inner=make_args(a=1))),
+            R"({"items":[1,2],"inner":{"a":1}})"sv);
+  EXPECT_EQ(erl::to_json(make_args(nan=std::numeric_limits<double>::quiet_NaN())), R"({"nan":null})"sv);
+}
+
+TEST(Structured, JsonEscape) {
+  EXPECT_EQ(erl::to_json(make_args(s="a\"b\\c\n\t\x01")), R"({"s":"a\"b\\c\n\t\u0001"})"sv);
+
+  // long strings take the word-at-a-time path, escapes at every offset
+  for (std::size_t offset = 0; offset < 20; ++offset) {
+    std::string text(offset, 'x');
+    text += '"';
+    text += std::string(20, 'y');
+    EXPECT_EQ(erl::to_json(make_args(text)),
+              R"({"text":")" + std::string(offset, 'x') + R"(\")" + std::string(20, 'y') + R"("})");
+  }
+
+  // bytes above 0x7f (UTF-8) are not escaped
+  EXPECT_EQ(erl::to_json(make_args(s="gr\xc3\xbc\xc3\x9f dich")), "{\"s\":\"gr\xc3\xbc\xc3\x9f dich\"}"sv);
+}
+
+TEST(Structured, Logfmt) {
+  EXPECT_EQ(erl::to_logfmt(make_args()), ""sv);
+  EXPECT_EQ(erl::to_logfmt(make_args(id=42, ok=false, path="/a/b")), "id=42 ok=false path=/a/b"sv);
+  EXPECT_EQ(erl::to_logfmt(make_args(msg="hello world", eq="a=b", empty="")),
+            R"(msg="hello world" eq="a=b" empty="")"sv);
+  EXPECT_EQ(erl::to_logfmt(make_args(req=make_args(id=1, method="GET"), ms=2.5)), "req.id=1 req.method=GET ms=2.5"sv);
+  EXPECT_EQ(erl::to_logfmt(make_args(a=std::optional<int>{}, b=std::optional<int>{1})), "a= b=1"sv);
+}
+
+TEST(Structured, Iterator) {
+  std::string out;
+  erl::to_json(std::back_inserter(out), make_args(x=1));
+  out += ' ';
+  erl::to_logfmt(std::back_inserter(out), make_args(x=1));
+  EXPECT_EQ(out, R"({"x":1} x=1)"sv);
+}
@@ -0,0 +1,83 @@
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#define KWARGS_FORMATTING 1
+#include <kwargs.h>
+
+using namespace std::string_view_literals;
+
+namespace {
+// every make_args call site yields its own type, packs passed to a template must come from one place
+auto request(int id, double us, std::string path) {
+  return make_args(id, us, path);
+}
+using request_args = decltype(request(0, 0.0, {}));
+
+struct Opaque {};
+}  // namespace
+
+TEST(Template, Format) {
+  auto tmpl = erl::compile_template<request_args>("req {id} took {us}us ({path})");
+  EXPECT_EQ(tmpl.format(request(1, 2.5, std::string{"/a"})), "req 1 took 2.5us (/a)"sv);
+  EXPECT_EQ(tmpl.format(request(2, 0.5, std::string{"/b"})), "req 2 took 0.5us (/b)"sv);
+}
+
+TEST(Template, Specs) {
+  auto tmpl = erl::compile_template<request_args>("{{{id:>4}}} {us:.1f} {path:?} {id:#x}");
+  EXPECT_EQ(tmpl.format(request(10, 1.25, std::string{"p"})), R"({  10} 1.2 "p" 0xa)"sv);
+}
+
+TEST(Template, FormatTo) {
+  auto tmpl = erl::compile_template<request_args>("{path}:{id}");
+  auto args = request(7, 0.0, std::string(1000, 'x'));
+
+  std::string out;
+  tmpl.format_to(std::back_inserter(out), args);
+  EXPECT_EQ(out, std::string(1000, 'x') + ":7");
+  EXPECT_EQ(tmpl.formatted_size(args), 1002);
+}
+
+TEST(Template, Errors) {
+  EXPECT_THROW(erl::compile_template<request_args>("{foo}"), std::format_error);
+  EXPECT_THROW(erl::compile_template<request_args>("{}"), std::format_error);
+  EXPECT_THROW(erl::compile_template<request_args>("{id"), std::format_error);
+  EXPECT_THROW(erl::compile_template<request_args>("id}"), std::format_error);
+  EXPECT_THROW(erl::compile_template<request_args>("{id:{us}}"), std::format_error);
+
+  using opaque_args = decltype(make_args(x = 1, opaque = Opaque{}));
+  EXPECT_NO_THROW(erl::compile_template<opaque_args>("{x}"));
+  EXPECT_THROW(erl::compile_template<opaque_args>("{opaque}"), std::format_error);
+
+  // format specs are checked against the argument type when the template is compiled
+  EXPECT_THROW(erl::compile_template<request_args>("{id:z}"), std::format_error);
+  EXPECT_THROW(erl::compile_template<request_args>("{id:.2}"), std::format_error);
+  EXPECT_THROW(erl::compile_template<request_args>("{us:d}"), std::format_error);
+  EXPECT_THROW(erl::compile_template<request_args>("{path} {path:x}"), std::format_error);
+  EXPECT_NO_THROW(erl::compile_template<request_args>("{id:>8x} {us:+.3e} {path:*^10}"));
+
+  try {
+    erl::compile_template<request_args>("{id} {us:d}");
+    FAIL();
+  } catch (std::format_error const& error) {
+    EXPECT_NE(std::string_view{error.what()}.find("`us`"), std::string_view::npos) << error.what();
+  }
+}
+
+TEST(Template, Shared) {
+  auto const tmpl = erl::compile_template<request_args>("{id}");
+  std::vector<std::string> results(4);
+  {
+    std::vector<std::jthread> threads;
+    for (int idx = 0; idx < 4; ++idx) {
+      threads.emplace_back([&, idx] { results[idx] = tmpl.format(request(idx, 0.0, std::string{})); });
+    }
+  }
+  for (int idx = 0; idx < 4; ++idx) {
+    EXPECT_EQ(results[idx], std::to_string(idx));
+  }
+}
@@ -0,0 +1,80 @@
+#include <concepts>
+#include <string>
+#include <tuple>
+#include <gtest/gtest.h>
+#include <kwargs.h>
+
+#include "tracked.h"
+
+namespace {
+using test::Tracked;
+
+template <typename T>
+int sum(erl::kwargs_t<T> const& kwargs) {
+  return get<"a">(kwargs).value + get_or<"b">(kwargs, 0);
+}
+}  // namespace
+
+TEST(Borrow, Members) {
+  Tracked a{1};
+  int const limit = 4;
+
+  auto args = make_args_ref(a, b = limit);
+  using args_t = decltype(args);
+  static_assert(erl::is_kwargs_ref<args_t>);
+  static_assert(!erl::is_kwargs_ref<decltype(make_args(a))>);
+  static_assert(std::tuple_size_v<args_t> == 2);
+  static_assert(std::same_as<std::tuple_element_t<0, args_t>, Tracked&>);
+  static_assert(std::same_as<std::tuple_element_t<1, args_t>, int const&>);
+  static_assert(erl::has_arg<args_t>("a"));
+  static_assert(!erl::has_arg<args_t>("c"));
+
+  EXPECT_EQ(&get<"a">(args), &a);
+  EXPECT_EQ(&get<1>(args), &limit);
+  EXPECT_EQ(get_or<"c">(args, 3), 3);
+}
+
+TEST(Borrow, ZeroCopies) {
+  Tracked a{1};
+  int b = 2;
+  Tracked::reset();
+
+  EXPECT_EQ(sum(make_args_ref(a, b)), 3);
+  EXPECT_EQ(sum(make_args_ref(a)), 1);
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 0);
+}
+
+TEST(Borrow, Aliasing) {
+  int value = 1;
+  auto args = make_args_ref(x = value);
+  value     = 2;
+  EXPECT_EQ(get<"x">(args), 2);
+  get<"x">(args) = 3;
+  EXPECT_EQ(value, 3);
+}
+
+#if KWARGS_FORMATTING == 1
+TEST(Borrow, Format) {
+  int foo = 1;
+  std::string bar = "two";
+  EXPECT_EQ(erl::format("{foo} {bar}", make_args_ref(foo, bar)), "1 two");
+}
+#endif
+
+#if __has_feature(parameter_reflection)
+namespace {
+int scaled(int factor, Tracked const& a) {
+  return factor * a.value;
+}
+}  // namespace
+
+TEST(Borrow, Invoke) {
+  Tracked a{3};
+  Tracked::reset();
+
+  EXPECT_EQ(erl::kwargs::invoke<^^scaled>(2, make_args_ref(a)), 6);
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 0);
+}
+#endif
@@ -0,0 +1,44 @@
+#include <concepts>
+#include <string>
+#include <gtest/gtest.h>
+
+#define KWARGS_CANONICAL 1
+#include <kwargs.h>
+
+namespace {
+template <typename T>
+std::string describe(erl::kwargs_t<T> const& kwargs) {
+  return std::to_string(get<"x">(kwargs)) + " " + std::to_string(get<"y">(kwargs));
+}
+}  // namespace
+
+TEST(Canonical, Interned) {
+  int x = 1;
+  using a = decltype(make_args(x = 1, y = 2.0));
+  using b = decltype(make_args(y=3.0,x=4));
+  using c = decltype(make_args(x, y = 5.0));
+  static_assert(std::same_as<a, b>);
+  static_assert(std::same_as<a, c>);
+
+  // different types or names yield different packs
+  static_assert(!std::same_as<a, decltype(make_args(x = 1, y = 2))>);
+  static_assert(!std::same_as<a, decltype(make_args(x = 1, z = 2.0))>);
+
+  // packs defined without canonicalization are distinct
+  static_assert(!std::same_as<a, decltype(erl::kwargs::make<"x, y">(1, 2.0))>);
+  static_assert(std::same_as<a, decltype(erl::kwargs::make<"y, x", true>(2.0, 1))>);
+}
+
+TEST(Canonical, Order) {
+  auto args = make_args(y = 2, x = 1);
+  EXPECT_EQ(get<0>(args), 1);
+  EXPECT_EQ(get<1>(args), 2);
+  EXPECT_EQ(get<"x">(args), 1);
+  EXPECT_EQ(get<"y">(args), 2);
+  EXPECT_EQ(describe(args), describe(make_args(x = 1, y = 2)));
+}
+
+TEST(Canonical, Empty) {
+  static_assert(std::same_as<decltype(make_args()), decltype(make_args())>);
+  EXPECT_EQ(std::tuple_size_v<decltype(make_args())>, 0);
+}
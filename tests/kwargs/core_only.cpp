@@ -0,0 +1,54 @@
+#include <meta>
+#include <string_view>
+#include <gtest/gtest.h>
+
+// the core header is self-contained and usable without the formatting part
+#include <kwargs/core.h>
+
+namespace {
+consteval bool declares(std::meta::info scope, std::string_view name) {
+  for (auto member : members_of(scope, std::meta::access_context::unchecked())) {
+    if (has_identifier(member) && identifier_of(member) == name) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+// everything beyond building and reading packs lives in opt-in headers
+static_assert(declares(^^erl, "make_args") && declares(^^erl, "get") && declares(^^erl, "get_or"));
+static_assert(!declares(^^erl, "kwargs_view"));
+static_assert(!declares(^^erl, "serialize") && !declares(^^erl, "deserialize"));
+static_assert(!declares(^^erl, "visit_arg") && !declares(^^erl, "find_arg"));
+static_assert(!declares(^^erl, "parse_args"));
+static_assert(!declares(^^erl, "stats"));
+static_assert(!declares(^^erl::kwargs, "invoke") && !declares(^^erl::kwargs, "bind"));
+static_assert(!declares(^^erl, "format") && !declares(^^erl, "formatting"));
+
+TEST(CoreHeader, Standalone) {
+  auto args = make_args(x = 42, name = std::string_view{"foo"});
+  static_assert(erl::is_kwargs<decltype(args)>);
+  EXPECT_EQ(get<"x">(args), 42);
+  EXPECT_EQ(get_or<"y">(args, 3), 3);
+  EXPECT_EQ(get<"name">(args), "foo");
+}
+
+// opt-in headers build on the core alone
+#include <kwargs/view.h>
+#include <kwargs/lookup.h>
+
+static_assert(declares(^^erl, "kwargs_view") && declares(^^erl, "visit_arg"));
+static_assert(!declares(^^erl, "serialize") && !declares(^^erl, "parse_args"));
+
+namespace {
+int read_x(erl::kwargs_view args) {
+  return args.get<int>("x");
+}
+}  // namespace
+
+TEST(CoreHeader, OptIn) {
+  auto args = make_args(x = 42);
+  EXPECT_EQ(read_x(args), 42);
+  EXPECT_NE(erl::find_arg<int>(args, "x"), nullptr);
+}
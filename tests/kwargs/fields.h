@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <kwargs.h>
+
+namespace test {
+// "field_0, field_1, ..., field_<N-1>"
+template <std::size_t N>
+consteval std::string field_list() {
+  std::string result;
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    if (idx != 0) {
+      result += ", ";
+    }
+    result += "field_" + erl::_kwargs_impl::utos(static_cast<unsigned>(idx));
+  }
+  return result;
+}
+
+template <std::size_t N>
+constexpr auto field_names = erl::_kwargs_impl::fixed_string<field_list<N>().size()>{std::string_view{field_list<N>()}};
+
+// pack of N int members, field_<idx> holds idx
+template <std::size_t N>
+auto make_fields() {
+  return [:erl::_kwargs_impl::sequence(N):] >> []<auto... Idx> {
+    return erl::make_args<field_names<N>>(static_cast<int>(Idx)...);
+  };
+}
+
+template <std::size_t N>
+using fields_t = decltype(make_fields<N>());
+}  // namespace test
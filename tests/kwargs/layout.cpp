@@ -0,0 +1,62 @@
+#include <array>
+#include <string_view>
+#include <tuple>
+#include <gtest/gtest.h>
+#include <kwargs.h>
+
+namespace {
+struct Padded {
+  char a;
+  double b;
+  char c;
+  double d;
+};
+
+struct Compact {
+  double b;
+  double d;
+  char a;
+  char c;
+};
+}  // namespace
+
+TEST(Layout, Size) {
+  auto args = make_args(a='a', b=1.0, c='c', d=2.0);
+  static_assert(sizeof(Padded) > sizeof(Compact));
+  static_assert(sizeof(args) == sizeof(Compact));
+
+  // packs already in order get no tag
+  static_assert(sizeof(make_args(b=1.0, a='a')) == sizeof(double) * 2);
+  static_assert(sizeof(make_args(x=1, y=2)) == sizeof(int) * 2);
+}
+
+TEST(Layout, ArgumentOrder) {
+  auto args   = make_args(a='a', b=1.0, c='c', d=2.0);
+  using args_t = decltype(args);
+
+  // indices and names keep referring to the arguments as written
+  static_assert(std::tuple_size_v<args_t> == 4);
+  static_assert(std::same_as<std::tuple_element_t<0, args_t>, char>);
+  static_assert(std::same_as<std::tuple_element_t<1, args_t>, double>);
+  static_assert(std::ranges::equal(erl::_kwargs_impl::get_member_names<args_t::type>(),
+                                   std::array<std::string_view, 4>{"a", "b", "c", "d"}));
+  static_assert(erl::_kwargs_impl::get_member_index<args_t::type>("c") == 2);
+
+  EXPECT_EQ(get<0>(args), 'a');
+  EXPECT_EQ(get<1>(args), 1.0);
+  EXPECT_EQ(get<2>(args), 'c');
+  EXPECT_EQ(get<3>(args), 2.0);
+  EXPECT_EQ(get<"d">(args), 2.0);
+  EXPECT_EQ(args.c, 'c');
+
+  auto [a, b, c, d] = args;
+  EXPECT_EQ(a, 'a');
+  EXPECT_EQ(d, 2.0);
+}
+
+TEST(Layout, Merge) {
+  auto merged = erl::merge(make_args(a='a', b=1.0), make_args(c='c', d=2.0));
+  static_assert(sizeof(merged) == sizeof(Compact));
+  EXPECT_EQ(get<0>(merged), 'a');
+  EXPECT_EQ(get<3>(merged), 2.0);
+}
@@ -0,0 +1,79 @@
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <gtest/gtest.h>
+#include <kwargs.h>
+
+#include "fields.h"
+
+using namespace std::string_view_literals;
+
+TEST(Lookup, Visit) {
+  auto args = make_args(x = 42, name = std::string{"foo"}, ratio = 0.5);
+
+  std::string seen;
+  auto collect = [&](auto const& value) {
+    if constexpr (std::is_arithmetic_v<std::remove_cvref_t<decltype(value)>>) {
+      seen += std::to_string(value);
+    } else {
+      seen += value;
+    }
+  };
+  EXPECT_TRUE(erl::visit_arg(args, "x", collect));
+  EXPECT_TRUE(erl::visit_arg(args, "name", collect));
+  EXPECT_FALSE(erl::visit_arg(args, "missing", collect));
+  EXPECT_FALSE(erl::visit_arg(args, "", collect));
+  EXPECT_FALSE(erl::visit_arg(args, "nam", collect));
+  EXPECT_EQ(seen, "42foo");
+
+  EXPECT_TRUE(erl::visit_arg(args, "x", [](auto& value) {
+    if constexpr (std::same_as<std::remove_cvref_t<decltype(value)>, int>) {
+      value = 7;
+    }
+  }));
+  EXPECT_EQ(get<"x">(args), 7);
+}
+
+TEST(Lookup, ValueCategory) {
+  auto args = make_args(name = std::string{"moved"});
+  std::string target;
+  EXPECT_TRUE(erl::visit_arg(std::move(args), "name", [&]<typename V>(V&& value) {
+    static_assert(std::is_rvalue_reference_v<V&&>);
+    target = std::forward<V>(value);
+  }));
+  EXPECT_EQ(target, "moved");
+}
+
+TEST(Lookup, Find) {
+  int value  = 3;
+  auto args  = make_args(x = 42, name = "foo"sv);
+  auto refs  = make_args_ref(value);
+
+  ASSERT_NE(erl::find_arg<int>(args, "x"), nullptr);
+  *erl::find_arg<int>(args, "x") = 5;
+  EXPECT_EQ(get<"x">(args), 5);
+
+  EXPECT_EQ(erl::find_arg<long>(args, "x"), nullptr);
+  EXPECT_EQ(erl::find_arg<int>(args, "name"), nullptr);
+  EXPECT_EQ(erl::find_arg<int>(args, "y"), nullptr);
+  EXPECT_EQ(*erl::find_arg<std::string_view>(args, "name"), "foo");
+
+  auto const& cargs = args;
+  EXPECT_EQ(erl::find_arg<int const>(cargs, "x"), &get<"x">(args));
+  EXPECT_EQ(erl::find_arg<int>(cargs, "x"), nullptr);
+
+  // reference members yield the referenced object
+  EXPECT_EQ(erl::find_arg<int>(refs, "value"), &value);
+}
+
+TEST(Lookup, LargePack) {
+  auto args = test::make_fields<64>();
+  for (int idx = 0; idx < 64; ++idx) {
+    auto const* value = erl::find_arg<int>(args, "field_" + std::to_string(idx));
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, idx);
+  }
+  EXPECT_EQ(erl::find_arg<int>(args, "field_64"), nullptr);
+  EXPECT_FALSE(erl::visit_arg(args, "field", [](int) {}));
+}
@@ -0,0 +1,82 @@
+#include <array>
+#include <concepts>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <gtest/gtest.h>
+#include <kwargs.h>
+
+#include "tracked.h"
+
+namespace {
+using test::Tracked;
+
+template <typename T>
+concept can_borrow = requires(T&& pack) { erl::merge_ref(std::forward<T>(pack)); };
+}  // namespace
+
+TEST(Merge, Union) {
+  auto defaults = make_args(timeout = 10, retries = 3, name = std::string{"default"});
+  auto config   = make_args(retries = 5, verbose = true);
+  auto call     = make_args(timeout = 1);
+
+  auto merged = erl::merge(defaults, config, call);
+  using merged_t = decltype(merged);
+  static_assert(erl::is_kwargs<merged_t>);
+  static_assert(std::tuple_size_v<merged_t> == 4);
+  static_assert(std::ranges::equal(erl::_kwargs_impl::get_member_names<merged_t::type>(),
+                                   std::array<std::string_view, 4>{"timeout", "retries", "name", "verbose"}));
+
+  EXPECT_EQ(get<"timeout">(merged), 1);
+  EXPECT_EQ(get<"retries">(merged), 5);
+  EXPECT_EQ(get<"name">(merged), "default");
+  EXPECT_EQ(get<"verbose">(merged), true);
+
+  // sources are left untouched
+  EXPECT_EQ(get<"name">(defaults), "default");
+}
+
+TEST(Merge, Types) {
+  auto merged = erl::merge(make_args(x = 1), make_args(x = 2.5));
+  static_assert(std::same_as<std::tuple_element_t<0, decltype(merged)>, double>);
+  EXPECT_EQ(get<"x">(merged), 2.5);
+
+  // merging the same members yields the same type
+  static_assert(std::same_as<decltype(erl::merge(make_args(x = 1), make_args(y = 2))),
+                             decltype(erl::merge(make_args(x = 3, y = 4)))>);
+}
+
+TEST(Merge, Moves) {
+  auto base      = make_args(a = Tracked{1}, b = Tracked{2});
+  auto overrides = make_args(b = Tracked{3});
+  Tracked::reset();
+
+  auto merged = erl::merge(std::move(base), overrides);
+  EXPECT_EQ(get<"a">(merged).value, 1);
+  EXPECT_EQ(get<"b">(merged).value, 3);
+  // `a` is moved from the rvalue pack, `b` copied from the lvalue override,
+  // the overridden `b` of the base pack is not touched
+  EXPECT_EQ(Tracked::moves, 1);
+  EXPECT_EQ(Tracked::copies, 1);
+}
+
+TEST(Merge, Borrow) {
+  auto base            = make_args(a = Tracked{1}, b = 2);
+  auto const overrides = make_args(b = 3);
+  Tracked::reset();
+
+  auto merged = erl::merge_ref(base, overrides);
+  static_assert(erl::is_kwargs_ref<decltype(merged)>);
+  static_assert(std::same_as<std::tuple_element_t<0, decltype(merged)>, Tracked&>);
+  static_assert(std::same_as<std::tuple_element_t<1, decltype(merged)>, int const&>);
+
+  EXPECT_EQ(&get<"a">(merged), &get<"a">(base));
+  EXPECT_EQ(&get<"b">(merged), &get<"b">(overrides));
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 0);
+
+  // borrowing from temporaries would dangle
+  static_assert(can_borrow<decltype(base)&>);
+  static_assert(!can_borrow<decltype(base)>);
+}
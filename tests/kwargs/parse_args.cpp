@@ -0,0 +1,129 @@
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gtest/gtest.h>
+#include <kwargs.h>
+
+#include "fields.h"
+
+using namespace std::string_view_literals;
+
+namespace {
+enum class Mode { fast, safe };
+
+auto options(int port, std::string_view host, bool verbose, double ratio, Mode mode, std::optional<int> limit,
+             std::string name) {
+  return make_args(port, host, verbose, ratio, mode, limit, name);
+}
+using options_t = decltype(options(0, {}, false, 0, Mode::fast, {}, {}));
+
+auto defaults() {
+  return options(8080, "localhost", false, 1.0, Mode::safe, std::nullopt, "app");
+}
+
+template <std::size_t N>
+consteval bool finds_all_fields() {
+  using table = erl::_kwargs_impl::perfect_hash<typename test::fields_t<N>::type>;
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    if (table::find("field_" + erl::_kwargs_impl::utos(static_cast<unsigned>(idx))) != idx) {
+      return false;
+    }
+  }
+  return table::bits >= 0 && table::find("field_") == -1UZ && table::find("field_" + erl::_kwargs_impl::utos(N)) == -1UZ;
+}
+
+std::expected<options_t, erl::parse_error> parse(std::vector<char const*> args, erl::parse_options opts = {}) {
+  args.insert(args.begin(), "prog");
+  return erl::parse_args(defaults(), static_cast<int>(args.size()), args.data(), opts);
+}
+}  // namespace
+
+TEST(ParseArgs, Defaults) {
+  auto result = parse({});
+  ASSERT_TRUE(result);
+  EXPECT_EQ(get<"port">(*result), 8080);
+  EXPECT_EQ(get<"host">(*result), "localhost"sv);
+  EXPECT_EQ(get<"mode">(*result), Mode::safe);
+  EXPECT_FALSE(get<"limit">(*result));
+}
+
+TEST(ParseArgs, Options) {
+  auto result = parse({"--port=9000", "--host", "example.org", "--verbose", "--ratio=0.25", "--mode=fast",
+                       "--limit", "3", "--name=svc"});
+  ASSERT_TRUE(result);
+  EXPECT_EQ(get<"port">(*result), 9000);
+  EXPECT_EQ(get<"host">(*result), "example.org"sv);
+  EXPECT_TRUE(get<"verbose">(*result));
+  EXPECT_EQ(get<"ratio">(*result), 0.25);
+  EXPECT_EQ(get<"mode">(*result), Mode::fast);
+  EXPECT_EQ(get<"limit">(*result), 3);
+  EXPECT_EQ(get<"name">(*result), "svc");
+
+  result = parse({"--verbose=yes", "--no-verbose", "--", "--ignored"});
+  ASSERT_TRUE(result);
+  EXPECT_FALSE(get<"verbose">(*result));
+}
+
+TEST(ParseArgs, Dashes) {
+  auto result = erl::parse_args(make_args(dry_run = false, max_jobs = 1), 3,
+                                std::array<char const*, 3>{"prog", "--dry-run", "--max-jobs=4"}.data());
+  ASSERT_TRUE(result);
+  EXPECT_TRUE(get<"dry_run">(*result));
+  EXPECT_EQ(get<"max_jobs">(*result), 4);
+}
+
+TEST(ParseArgs, Errors) {
+  using kind = erl::parse_error::kind;
+  auto check = [](std::vector<char const*> args, kind code, std::string_view option) {
+    auto result = parse(std::move(args));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().code, code);
+    EXPECT_EQ(result.error().option, option);
+  };
+
+  check({"--unknown=1"}, kind::unknown_option, "unknown");
+  check({"--no-port"}, kind::unknown_option, "no-port");
+  check({"--port"}, kind::missing_value, "port");
+  check({"--port=80x"}, kind::invalid_value, "port");
+  check({"--port=99999999999"}, kind::invalid_value, "port");
+  check({"--mode=slow"}, kind::invalid_value, "mode");
+  check({"--verbose=maybe"}, kind::invalid_value, "verbose");
+  check({"positional"}, kind::unexpected_argument, "positional");
+}
+
+TEST(ParseArgs, Environment) {
+  ::setenv("KWTEST_PORT", "7000", 1);
+  ::setenv("KWTEST_HOST", "env.host", 1);
+
+  // the command line takes precedence over the environment
+  auto result = parse({"--host=cli.host"}, {.env_prefix = "KWTEST_"});
+  ASSERT_TRUE(result);
+  EXPECT_EQ(get<"port">(*result), 7000);
+  EXPECT_EQ(get<"host">(*result), "cli.host"sv);
+
+  ::setenv("KWTEST_PORT", "invalid", 1);
+  result = parse({}, {.env_prefix = "KWTEST_"});
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error().option, "port");
+
+  ::unsetenv("KWTEST_PORT");
+  ::unsetenv("KWTEST_HOST");
+}
+
+TEST(ParseArgs, PerfectHash) {
+  using table = erl::_kwargs_impl::perfect_hash<options_t::type>;
+  static_assert(table::find("port") == 0);
+  static_assert(table::find("name") == 6);
+  static_assert(table::find("nope") == -1UZ);
+  static_assert(table::find("") == -1UZ);
+}
+
+TEST(ParseArgs, PerfectHashLargePack) {
+  static_assert(finds_all_fields<64>());
+  static_assert(finds_all_fields<128>());
+}
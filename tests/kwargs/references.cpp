@@ -0,0 +1,120 @@
+#include <concepts>
+#include <memory>
+#include <utility>
+#include <gtest/gtest.h>
+#include <kwargs.h>
+
+#include "tracked.h"
+
+using test::Tracked;
+
+TEST(References, Get) {
+  auto args = make_args(x = Tracked{1});
+  Tracked::reset();
+
+  static_assert(std::same_as<decltype(get<"x">(args)), Tracked&>);
+  static_assert(std::same_as<decltype(get<0>(args)), Tracked&>);
+  static_assert(std::same_as<decltype(get<"x">(std::as_const(args))), Tracked const&>);
+  static_assert(std::same_as<decltype(get<0>(std::as_const(args))), Tracked const&>);
+  static_assert(std::same_as<decltype(get<"x">(std::move(args))), Tracked&&>);
+
+  EXPECT_EQ(&get<"x">(args), &args.x);
+  EXPECT_EQ(&get<0>(args), &args.x);
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 0);
+}
+
+TEST(References, GetRvalue) {
+  auto args = make_args(x = Tracked{1});
+  Tracked::reset();
+
+  Tracked moved = get<"x">(std::move(args));
+  EXPECT_EQ(moved.value, 1);
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 1);
+}
+
+TEST(References, GetOr) {
+  auto args = make_args(x = Tracked{1});
+  Tracked fallback{2};
+  Tracked::reset();
+
+  EXPECT_EQ(&get_or<"x">(args, fallback), &args.x);
+  EXPECT_EQ(&get_or<0>(args, fallback), &args.x);
+  EXPECT_EQ(&get_or<"y">(args, fallback), &fallback);
+  EXPECT_EQ(&get_or<1>(args, fallback), &fallback);
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 0);
+
+  EXPECT_EQ(get_or<"y">(args, Tracked{3}).value, 3);
+  EXPECT_EQ(Tracked::copies, 0);
+}
+
+TEST(References, MoveOnly) {
+  auto args = make_args(ptr = std::make_unique<int>(42));
+  EXPECT_EQ(*get<"ptr">(args), 42);
+  EXPECT_EQ(*get_or<"ptr">(args, nullptr), 42);
+
+  auto ptr = get<"ptr">(std::move(args));
+  EXPECT_EQ(*ptr, 42);
+  EXPECT_EQ(args.ptr, nullptr);
+}
+
+#if __has_feature(parameter_reflection)
+namespace {
+int by_value(int scale, Tracked value) {
+  return scale * value.value;
+}
+
+int by_reference(int scale, Tracked const& value) {
+  return scale * value.value;
+}
+}  // namespace
+
+TEST(References, Invoke) {
+  auto args = make_args(value = Tracked{3});
+  Tracked::reset();
+
+  EXPECT_EQ(erl::kwargs::invoke<^^by_reference>(2, args), 6);
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 0);
+
+  EXPECT_EQ(erl::kwargs::invoke<^^by_value>(2, std::move(args)), 6);
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 1);
+}
+#endif
+
+#if __has_feature(parameter_reflection)
+namespace {
+int scaled(int x, int factor, int offset) {
+  return x * factor + offset;
+}
+}  // namespace
+
+TEST(References, Bind) {
+  auto bound = erl::kwargs::bind<^^scaled>(make_args(offset = 1, factor = 3));
+  EXPECT_EQ(bound(2), 7);
+  EXPECT_EQ(bound(5), 16);
+
+  // fewer positional arguments consume more of the bound pack
+  auto all = erl::kwargs::bind<^^scaled>(make_args(offset = 1, factor = 3, x = 4));
+  EXPECT_EQ(all(), 13);
+
+  // the pack is stored by value, it is copied into `bind` exactly once
+  auto args = make_args(value = Tracked{3});
+  Tracked::reset();
+  auto by_ref = erl::kwargs::bind<^^by_reference>(args);
+  EXPECT_EQ(Tracked::copies, 1);
+  EXPECT_EQ(by_ref(2), 6);
+  EXPECT_EQ(by_ref(4), 12);
+  EXPECT_EQ(Tracked::copies, 1);
+  EXPECT_EQ(Tracked::moves, 0);
+
+  auto by_val = erl::kwargs::bind<^^by_value>(std::move(args));
+  Tracked::reset();
+  EXPECT_EQ(std::move(by_val)(2), 6);
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(Tracked::moves, 1);
+}
+#endif
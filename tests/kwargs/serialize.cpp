@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gtest/gtest.h>
+#include <kwargs.h>
+
+namespace {
+auto job(int id, double weight, std::string name, std::vector<std::int32_t> items) {
+  return make_args(id, weight, name, items);
+}
+using job_t = decltype(job(0, 0, {}, {}));
+
+auto point(double x, double y, std::int64_t tag) {
+  return make_args(x, y, tag);
+}
+using point_t = decltype(point(0, 0, 0));
+
+enum Level { low, mid, high };
+enum class Id : std::uint32_t {};
+
+auto state(bool flag, Level level, Id id) {
+  return make_args(flag, level, id);
+}
+using state_t = decltype(state(false, low, {}));
+
+// index of the single byte in which the serialized forms of two packs differ
+std::size_t differing_byte(state_t const& lhs, state_t const& rhs) {
+  std::vector<std::byte> first;
+  std::vector<std::byte> second;
+  erl::serialize(lhs, first);
+  erl::serialize(rhs, second);
+  return static_cast<std::size_t>(std::ranges::mismatch(first, second).in1 - first.begin());
+}
+
+struct Linked {
+  int value;
+  Linked* next;
+};
+}  // namespace
+
+TEST(Serialize, RoundTrip) {
+  auto original = job(7, 0.5, "resize", {1, 2, 3});
+
+  std::vector<std::byte> buffer;
+  erl::serialize(original, buffer);
+  EXPECT_EQ(buffer.size(), erl::serialized_size(original));
+
+  auto copy = erl::deserialize<job_t>(buffer);
+  ASSERT_TRUE(copy);
+  EXPECT_EQ(get<"id">(*copy), 7);
+  EXPECT_EQ(get<"weight">(*copy), 0.5);
+  EXPECT_EQ(get<"name">(*copy), "resize");
+  EXPECT_EQ(get<"items">(*copy), (std::vector<std::int32_t>{1, 2, 3}));
+}
+
+TEST(Serialize, Schema) {
+  static_assert(erl::schema_hash<job_t> != erl::schema_hash<point_t>);
+  // borrowing packs and views share the schema of the owning pack
+  static_assert(erl::schema_hash<point_t> == erl::schema_hash<decltype(make_args(x = 0.0, y = 0.0, tag = std::int64_t{}))>);
+  static_assert(erl::schema_hash<job_t> == erl::schema_hash<erl::serialized_view_t<job_t>>);
+  // independent of how the compiler spells type names
+  static_assert(erl::schema_hash<job_t> ==
+                erl::_kwargs_impl::hash_name("{id:i32;weight:f64;name:string;items:vector<i32>;}"));
+  static_assert(erl::schema_hash<decltype(make_args(a = std::int64_t{}))> ==
+                erl::schema_hash<decltype(make_args(a = 0LL))>);
+
+  std::vector<std::byte> buffer;
+  erl::serialize(point(1, 2, 3), buffer);
+  EXPECT_FALSE(erl::deserialize<job_t>(buffer));
+
+  // truncated data
+  ASSERT_TRUE(erl::deserialize<point_t>(buffer));
+  buffer.pop_back();
+  EXPECT_FALSE(erl::deserialize<point_t>(buffer));
+  EXPECT_FALSE(erl::deserialize<point_t>({}));
+}
+
+TEST(Serialize, Borrowed) {
+  double x = 1.5;
+  double y = 2.5;
+  std::int64_t tag = 9;
+
+  std::vector<std::byte> buffer;
+  erl::serialize(make_args_ref(x, y, tag), buffer);
+
+  auto copy = erl::deserialize<decltype(make_args(x, y, tag))>(buffer);
+  ASSERT_TRUE(copy);
+  EXPECT_EQ(get<"y">(*copy), 2.5);
+  EXPECT_EQ(get<"tag">(*copy), 9);
+}
+
+TEST(Serialize, Bulk) {
+  static_assert(erl::_kwargs_impl::is_bulk_serializable<point_t::type>());
+  static_assert(!erl::_kwargs_impl::is_bulk_serializable<job_t::type>());
+
+  auto original = point(1, 2, 3);
+  alignas(16) std::byte storage[64];
+  auto size = erl::serialize(original, storage);
+  EXPECT_EQ(size, 16 + sizeof(point_t));
+
+  auto const* mapped = erl::serialized_cast<point_t>(std::span{storage, size});
+  ASSERT_NE(mapped, nullptr);
+  EXPECT_EQ(get<"x">(*mapped), 1);
+  EXPECT_EQ(get<"tag">(*mapped), 3);
+
+  EXPECT_THROW(erl::serialize(original, std::span{storage, 8}), std::length_error);
+}
+
+TEST(Serialize, View) {
+  std::vector<std::byte> buffer;
+  erl::serialize(job(1, 2, "shared", {4, 5}), buffer);
+
+  auto view = erl::deserialize_view<job_t>(buffer);
+  ASSERT_TRUE(view);
+  static_assert(std::same_as<decltype(get<"name">(*view)), std::string_view&>);
+  static_assert(std::same_as<decltype(get<"items">(*view)), std::span<std::int32_t const>&>);
+
+  // refers into the buffer
+  EXPECT_EQ(get<"name">(*view), "shared");
+  EXPECT_GE(get<"name">(*view).data(), reinterpret_cast<char const*>(buffer.data()));
+  EXPECT_LT(get<"name">(*view).data(), reinterpret_cast<char const*>(buffer.data() + buffer.size()));
+  ASSERT_EQ(get<"items">(*view).size(), 2);
+  EXPECT_EQ(get<"items">(*view)[1], 5);
+
+  // views serialize like the owning pack
+  std::vector<std::byte> again;
+  erl::serialize(*view, again);
+  EXPECT_EQ(again, buffer);
+}
+
+TEST(Serialize, InvalidValues) {
+  // pointers are not part of the wire format
+  static_assert(!erl::_kwargs_impl::is_raw_serializable<Linked>);
+  static_assert(!erl::_kwargs_impl::is_raw_serializable<int*>);
+
+  std::vector<std::byte> buffer;
+  erl::serialize(state(true, mid, Id{0xdead'beef}), buffer);
+  auto copy = erl::deserialize<state_t>(buffer);
+  ASSERT_TRUE(copy);
+  // enums with a fixed underlying type accept every value
+  EXPECT_EQ(get<"id">(*copy), Id{0xdead'beef});
+
+  auto corrupted = buffer;
+  corrupted[differing_byte(state(true, mid, {}), state(false, mid, {}))] = std::byte{2};
+  EXPECT_FALSE(erl::deserialize<state_t>(corrupted));
+
+  // Level only holds the values of a 2 bit field
+  corrupted = buffer;
+  corrupted[differing_byte(state(true, low, {}), state(true, mid, {}))] = std::byte{7};
+  EXPECT_FALSE(erl::deserialize<state_t>(corrupted));
+  corrupted[differing_byte(state(true, low, {}), state(true, mid, {}))] = std::byte{3};
+  EXPECT_TRUE(erl::deserialize<state_t>(corrupted));
+}
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <array>
+#include <string_view>
 #include <gtest/gtest.h>
 #include <kwargs.h>
 
@@ -46,4 +49,24 @@ TEST(KwArgs, Default) {
   EXPECT_EQ(get_by_idx_default(make_args(x=10)), 10);
   EXPECT_EQ(get_by_name_default(make_args()), 42);
   EXPECT_EQ(get_by_idx_default(make_args()), 42);
-}
\ No newline at end of file
+}
+
+TEST(KwArgs, Lookup) {
+  using args_t = decltype(make_args(zeta=1, alpha=2, mid=3))::type;
+  static_assert(erl::_kwargs_impl::get_member_index<args_t>("zeta") == 0);
+  static_assert(erl::_kwargs_impl::get_member_index<args_t>("alpha") == 1);
+  static_assert(erl::_kwargs_impl::get_member_index<args_t>("mid") == 2);
+  static_assert(erl::_kwargs_impl::get_member_index<args_t>("beta") == -1UZ);
+  static_assert(std::ranges::equal(erl::_kwargs_impl::get_member_names<args_t>(),
+                                   std::array<std::string_view, 3>{"zeta", "alpha", "mid"}));
+  EXPECT_EQ(erl::_kwargs_impl::member_count<args_t>, 3);
+}
+
+TEST(KwArgs, Literals) {
+  auto args = make_args(sep=",", paren="a(b", chr=',', x=1'000);
+  EXPECT_EQ(erl::_kwargs_impl::member_count<decltype(args)::type>, 4);
+  EXPECT_EQ(std::string_view(get<"sep">(args)), ",");
+  EXPECT_EQ(std::string_view(get<"paren">(args)), "a(b");
+  EXPECT_EQ(get<"chr">(args), ',');
+  EXPECT_EQ(get<"x">(args), 1000);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace test {
+// counts copy and move constructions, call reset() before the section under test
+struct Tracked {
+  static inline int copies = 0;
+  static inline int moves  = 0;
+
+  int value = 0;
+
+  Tracked() = default;
+  explicit Tracked(int value) : value(value) {}
+  Tracked(Tracked const& other) : value(other.value) { ++copies; }
+  Tracked(Tracked&& other) noexcept : value(other.value) { ++moves; }
+  Tracked& operator=(Tracked const&) = default;
+  Tracked& operator=(Tracked&&)      = default;
+
+  static void reset() {
+    copies = 0;
+    moves  = 0;
+  }
+};
+}  // namespace test
@@ -0,0 +1,61 @@
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <gtest/gtest.h>
+#include <kwargs.h>
+
+namespace {
+// ordinary non-template function accepting keyword arguments
+std::string connect(std::string_view host, erl::kwargs_view options) {
+  auto port    = options.get_or<int>("port", 80);
+  auto timeout = options.get_or<double>("timeout", 1.5);
+  return std::string(host) + ":" + std::to_string(port) + "/" + std::to_string(timeout);
+}
+}  // namespace
+
+TEST(View, OutOfLine) {
+  EXPECT_EQ(connect("a", make_args(port = 8080, timeout = 2.5)), "a:8080/" + std::to_string(2.5));
+  EXPECT_EQ(connect("b", make_args(timeout = 0.5)), "b:80/" + std::to_string(0.5));
+  EXPECT_EQ(connect("c", make_args()), "c:80/" + std::to_string(1.5));
+  EXPECT_EQ(connect("d", {}), "d:80/" + std::to_string(1.5));
+}
+
+TEST(View, Lookup) {
+  auto args = make_args(x = 1, name = std::string("foo"), flag = true);
+  erl::kwargs_view view = args;
+
+  EXPECT_EQ(view.size(), 3);
+  EXPECT_TRUE(view.contains("x"));
+  EXPECT_TRUE(view.contains("flag"));
+  EXPECT_FALSE(view.contains("y"));
+
+  EXPECT_EQ(view.find<int>("x"), &args.x);
+  EXPECT_EQ(view.get<std::string>("name"), "foo");
+  EXPECT_EQ(view.get<bool>("flag"), true);
+
+  // type mismatch
+  EXPECT_EQ(view.find<long>("x"), nullptr);
+  EXPECT_EQ(view.find<int>("y"), nullptr);
+  EXPECT_THROW((void)view.get<int>("name"), std::out_of_range);
+
+  // runtime keys
+  std::string key = "x";
+  EXPECT_EQ(view.get<int>(erl::kwargs_view::key{key}), 1);
+}
+
+TEST(View, Borrowed) {
+  int value             = 3;
+  auto args             = make_args_ref(value);
+  erl::kwargs_view view = args;
+  EXPECT_EQ(view.find<int>("value"), &value);
+}
+
+TEST(View, ManyMembers) {
+  auto args = make_args(a = 0, b = 1, c = 2, d = 3, e = 4, f = 5, g = 6, h = 7, i = 8, j = 9);
+  erl::kwargs_view view = args;
+  int sum               = 0;
+  for (auto key : {"a", "b", "c", "d", "e", "f", "g", "h", "i", "j"}) {
+    sum += view.get<int>(erl::kwargs_view::key{std::string_view{key}});
+  }
+  EXPECT_EQ(sum, 45);
+}
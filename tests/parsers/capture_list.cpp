@@ -82,3 +82,30 @@ TEST(CaptureList, Packs) {
     check_reject(capture_list);
   }
 }
+
+TEST(CaptureList, Literals) {
+  // delimiters and brackets inside string and character literals are not separators
+  std::vector<std::string_view> two_args = {
+      R"(x=",", y=1)",
+      R"(x="a(b", y=1)",
+      R"(x="a\"b,c", y=1)",
+      R"(x=',', y=1)",
+      R"(x='\'', y=1)",
+      R"(x=u8',', y=1)",
+      R"(x=L"}", y=1)",
+      R"(x=R"d(a", b)d", y=1)",
+      R"t(x=u8R"(,)", y=1)t",
+      R"(x=1'000, y=1)",
+      R"(x=0x1'f, y=',')",
+  };
+
+  for (auto capture_list : two_args) {
+    check(capture_list, {"x", "y"});
+  }
+}
+
+TEST(CaptureList, Capacity) {
+  EXPECT_TRUE(erl::kwargs::BasicNameParser<2>{"x, y"}.parse());
+  EXPECT_FALSE(erl::kwargs::BasicNameParser<1>{"x, y"}.parse());
+  static_assert(erl::kwargs::name_parser_for<"x,y">{"x,y"}.parse());
+}
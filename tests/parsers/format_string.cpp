@@ -33,4 +33,29 @@ TEST(FormatString, Mismatch) {
   check("{x}{foo}", {}, "{0}{0}");
   check("{x}{foo}", {"x"}, "{0}{1}");
   check("{x}{foo}", {"foo"}, "{1}{0}");
-}
\ No newline at end of file
+}
+
+namespace {
+consteval std::size_t compile(std::string_view fmt) {
+  std::vector<std::string_view> names = {"x", "y"};
+  auto plan = erl::formatting::FmtParser{fmt}.compile(names);
+  return plan ? plan->size() : -1UZ;
+}
+}
+
+TEST(FormatString, Compile) {
+  static_assert(compile("") == 0);
+  static_assert(compile("foo") == 1);
+  static_assert(compile("{x}") == 1);
+  static_assert(compile("{x} {y}") == 3);
+  static_assert(compile("foo{y}foo{x:>3}foo") == 5);
+  static_assert(compile("{{x}}") == 1);
+  static_assert(compile("{{{x}}}") == 3);
+
+  // not expressible as a plan
+  static_assert(compile("{}") == -1UZ);
+  static_assert(compile("{foo}") == -1UZ);
+  static_assert(compile("{x:{y}}") == -1UZ);
+  static_assert(compile("{x") == -1UZ);
+  static_assert(compile("x}") == -1UZ);
+}